@@ -1,12 +1,15 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "Item.h"
+#include "Shooter.h"
 #include "ShooterCharacter.h"
 #include "Components/WidgetComponent.h"
 #include "Components/BoxComponent.h"
+#include "Components/SphereComponent.h"
 
 // Sets default values
-AItem::AItem()
+AItem::AItem() :
+	PickupWidget(nullptr), bUsePickupWidgetComponent(false), ItemState(EItemState::EIS_Pickup)
 {
 	// Set this actor to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = true;
@@ -19,8 +22,8 @@ AItem::AItem()
 	CollisionBox->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
 	CollisionBox->SetCollisionResponseToChannel(ECollisionChannel::ECC_Visibility, ECollisionResponse::ECR_Block);
 
-	PickupWidget = CreateDefaultSubobject<UWidgetComponent>(TEXT("PickupWidget"));
-	PickupWidget->SetupAttachment(GetRootComponent());
+	AreaSphere = CreateDefaultSubobject<USphereComponent>(TEXT("AreaSphere"));
+	AreaSphere->SetupAttachment(GetRootComponent());
 }
 
 // Called when the game starts or when spawned
@@ -28,16 +31,98 @@ void AItem::BeginPlay()
 {
 	Super::BeginPlay();
 
-	//hide pickup widget
-	PickupWidget->SetVisibility(false);
+#if WITH_SHOOTER_COSMETICS
+	//Items share the HUD pickup prompt unless they opt in to their own widget, servers never create one
+	if (bUsePickupWidgetComponent && PickupWidgetClass && ShooterCosmetics::AreEnabled()) {
+		PickupWidget = NewObject<UWidgetComponent>(this, TEXT("PickupWidget"));
+		PickupWidget->SetWidgetClass(PickupWidgetClass);
+		PickupWidget->SetupAttachment(GetRootComponent());
+		PickupWidget->RegisterComponent();
+
+		//hide pickup widget
+		PickupWidget->SetVisibility(false);
+	}
+#endif
 
 	//Setup overlap for area sphere
+	AreaSphere->OnComponentBeginOverlap.AddDynamic(this, &AItem::OnSphereOverlap);
+	AreaSphere->OnComponentEndOverlap.AddDynamic(this, &AItem::OnSphereEndOverlap);
+
+	//Apply collision and visibility for the initial state
+	SetItemProperties(ItemState);
+}
+
+void AItem::OnSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp,
+	int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+{
+	if (AShooterCharacter* ShooterCharacter = Cast<AShooterCharacter>(OtherActor)) {
+		ShooterCharacter->IncrementOverlappedItemCount(1);
+	}
+}
 
+void AItem::OnSphereEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp,
+	int32 OtherBodyIndex)
+{
+	if (AShooterCharacter* ShooterCharacter = Cast<AShooterCharacter>(OtherActor)) {
+		ShooterCharacter->IncrementOverlappedItemCount(-1);
+	}
 }
 
+void AItem::SetItemState(EItemState State)
+{
+	ItemState = State;
+	SetItemProperties(State);
+}
+
+void AItem::SetItemProperties(EItemState State)
+{
+	//Pooled items sit idle until they are acquired again
+	SetActorTickEnabled(State != EItemState::EIS_Pooled);
+
+	switch (State) {
+	case EItemState::EIS_Pickup:
+		//Visible in the world, can be traced and overlapped
+		SetActorHiddenInGame(false);
+		SetActorEnableCollision(true);
+		ItemMesh->SetSimulatePhysics(false);
+		ItemMesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+
+		AreaSphere->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Overlap);
+		AreaSphere->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+
+		CollisionBox->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Ignore);
+		CollisionBox->SetCollisionResponseToChannel(ECollisionChannel::ECC_Visibility, ECollisionResponse::ECR_Block);
+		CollisionBox->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+		break;
+
+	case EItemState::EIS_Equipped:
+		//Visible in the character's hands, no collision
+		SetActorHiddenInGame(false);
+		SetActorEnableCollision(false);
+		ItemMesh->SetSimulatePhysics(false);
+		if (PickupWidget) {
+			PickupWidget->SetVisibility(false);
+		}
+		break;
+
+	case EItemState::EIS_PickedUp:
+	case EItemState::EIS_Pooled:
+		//Stored in an inventory or a pool, neither rendered nor collidable
+		SetActorHiddenInGame(true);
+		SetActorEnableCollision(false);
+		ItemMesh->SetSimulatePhysics(false);
+		if (PickupWidget) {
+			PickupWidget->SetVisibility(false);
+		}
+		break;
+
+	default:
+		break;
+	}
+}
 
 // Called every frame
 void AItem::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
-}
\ No newline at end of file
+}
@@ -6,10 +6,52 @@
 #include "GameFramework/Actor.h"
 #include "Item.generated.h"
 
+UENUM(BlueprintType)
+enum class EItemState : uint8
+{
+	EIS_Pickup UMETA(DisplayName = "Pickup"),
+	EIS_Equipped UMETA(DisplayName = "Equipped"),
+	EIS_PickedUp UMETA(DisplayName = "PickedUp"),
+	EIS_Pooled UMETA(DisplayName = "Pooled"),
+
+	EIS_MAX UMETA(DisplayName = "DefaultMAX")
+};
+
+UENUM(BlueprintType)
+enum class EItemRarity : uint8
+{
+	EIR_Damaged UMETA(DisplayName = "Damaged"),
+	EIR_Common UMETA(DisplayName = "Common"),
+	EIR_Uncommon UMETA(DisplayName = "Uncommon"),
+	EIR_Rare UMETA(DisplayName = "Rare"),
+	EIR_Legendary UMETA(DisplayName = "Legendary"),
+
+	EIR_MAX UMETA(DisplayName = "DefaultMAX")
+};
+
+//Data shown by the pickup prompt for the item under the crosshair
+USTRUCT(BlueprintType)
+struct FItemPickupInfo
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item Property")
+	FString ItemName = TEXT("Default");
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item Property")
+	EItemRarity ItemRarity = EItemRarity::EIR_Common;
+
+	//Ammo count for weapons, item count for everything else
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Item Property")
+	int32 ItemCount = 0;
+};
+
 UCLASS()
 class SHOOTER_API AItem : public AActor
 {
 	GENERATED_BODY()
+
+	friend class FItemPickupWidgetMemoryTest;
 	
 public:	
 	// Sets default values for this actor's properties
@@ -19,6 +61,19 @@ protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	//Called when overlapping the area sphere
+	UFUNCTION()
+	void OnSphereOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp,
+		int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
+
+	//Called when ending overlap with the area sphere
+	UFUNCTION()
+	void OnSphereEndOverlap(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp,
+		int32 OtherBodyIndex);
+
+	//Sets collision, visibility and tick for the components based on the item state
+	void SetItemProperties(EItemState State);
+
 public:	
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
@@ -31,10 +86,36 @@ private:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Property", meta = (AllowPrivateAccess = "true"))
 	class UBoxComponent* CollisionBox;
 
-	//Item pop-up widget 
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Property", meta = (AllowPrivateAccess = "true"))
+	//Item pop-up widget, only created when bUsePickupWidgetComponent is set
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Transient, Category = "Item Property", meta = (AllowPrivateAccess = "true"))
 	class UWidgetComponent* PickupWidget;
 
+	//Give this item its own widget component instead of the shared HUD pickup prompt
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Property", meta = (AllowPrivateAccess = "true"))
+	bool bUsePickupWidgetComponent;
+
+	//Widget used by the per-item widget component
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Property", meta = (AllowPrivateAccess = "true", EditCondition = "bUsePickupWidgetComponent"))
+	TSubclassOf<class UUserWidget> PickupWidgetClass;
+
+	//Name, rarity and count shown by the pickup prompt
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Property", meta = (AllowPrivateAccess = "true"))
+	FItemPickupInfo PickupInfo;
+
+	//Enables item tracing when overlapped
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Item Property", meta = (AllowPrivateAccess = "true"))
+	class USphereComponent* AreaSphere;
+
+	//Current state of the item (pickup, equipped, in inventory or pooled)
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Item Property", meta = (AllowPrivateAccess = "true"))
+	EItemState ItemState;
+
 public:
 	FORCEINLINE UWidgetComponent* GetPickupWidget() const { return PickupWidget; }
+	FORCEINLINE USkeletalMeshComponent* GetItemMesh() const { return ItemMesh; }
+	FORCEINLINE EItemState GetItemState() const { return ItemState; }
+	void SetItemState(EItemState State);
+
+	//Data for the pickup prompt, overridden by items that track extra state
+	virtual FItemPickupInfo GetPickupInfo() const { return PickupInfo; }
 };
@@ -0,0 +1,28 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PickupPromptWidget.h"
+#include "Blueprint/WidgetTree.h"
+#include "Components/TextBlock.h"
+
+void UPickupPromptWidget::NativeOnInitialized()
+{
+	Super::NativeOnInitialized();
+
+	//Without a designer layout (no Blueprint subclass set on the HUD) fall back to a plain text prompt
+	if (WidgetTree && WidgetTree->RootWidget == nullptr) {
+		DefaultText = WidgetTree->ConstructWidget<UTextBlock>(UTextBlock::StaticClass(), TEXT("DefaultText"));
+		DefaultText->SetJustification(ETextJustify::Center);
+		WidgetTree->RootWidget = DefaultText;
+	}
+}
+
+void UPickupPromptWidget::SetPickupInfo(const FItemPickupInfo& Info)
+{
+	PickupInfo = Info;
+
+	if (DefaultText) {
+		DefaultText->SetText(FText::Format(NSLOCTEXT("Shooter", "PickupPrompt", "{0} ({1})"), FText::FromString(PickupInfo.ItemName), FText::AsNumber(PickupInfo.ItemCount)));
+	}
+	OnPickupInfoChanged();
+}
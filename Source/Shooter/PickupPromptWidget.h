@@ -0,0 +1,38 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "Item.h"
+#include "PickupPromptWidget.generated.h"
+
+class UTextBlock;
+
+/**
+ * Pickup prompt shared by every item, filled in by the HUD for the focused item.
+ * Used as is it shows a plain text prompt, Blueprint subclasses replace it with their own layout.
+ */
+UCLASS()
+class SHOOTER_API UPickupPromptWidget : public UUserWidget
+{
+	GENERATED_BODY()
+
+public:
+	void SetPickupInfo(const FItemPickupInfo& Info);
+
+protected:
+	virtual void NativeOnInitialized() override;
+
+	//Called when the prompt switches to a different item, update the widget's text and rarity here
+	UFUNCTION(BlueprintImplementableEvent)
+	void OnPickupInfoChanged();
+
+private:
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Pickup", meta = (AllowPrivateAccess = "true"))
+	FItemPickupInfo PickupInfo;
+
+	//Text of the default prompt, null when a Blueprint subclass provides the layout
+	UPROPERTY(Transient)
+	UTextBlock* DefaultText;
+};
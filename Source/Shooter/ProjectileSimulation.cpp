@@ -0,0 +1,149 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ProjectileSimulation.h"
+#include "Shooter.h"
+#include "ShooterCharacter.h"
+#include "EngineUtils.h"
+#include "Async/ParallelFor.h"
+
+DECLARE_CYCLE_STAT(TEXT("Projectile Step"), STAT_ProjectileStep, STATGROUP_Shooter);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Projectiles In Flight"), STAT_ProjectilesInFlight, STATGROUP_Shooter);
+
+// Sets default values
+AProjectileSimulation::AProjectileSimulation() :
+	StepRate(60.0f), MaxStepsPerTick(4), MaxProjectiles(8192), MinParallelProjectiles(256), StepAccumulator(0.0f)
+{
+	// Tick after physics so the sweeps see this frame's collision
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.TickGroup = TG_PostPhysics;
+
+	SetRootComponent(CreateDefaultSubobject<USceneComponent>(TEXT("Root")));
+}
+
+// Called when the game starts or when spawned
+void AProjectileSimulation::BeginPlay()
+{
+	Super::BeginPlay();
+
+	//Allocate the whole pool once so launching never reallocates
+	Projectiles.Reserve(MaxProjectiles);
+	Instigators.Reserve(MaxProjectiles);
+	StepImpacts.Reserve(64);
+}
+
+AProjectileSimulation* AProjectileSimulation::Get(UWorld* World)
+{
+	if (World == nullptr) {
+		return nullptr;
+	}
+
+	for (TActorIterator<AProjectileSimulation> It(World); It; ++It) {
+		return *It;
+	}
+	return World->SpawnActor<AProjectileSimulation>();
+}
+
+bool AProjectileSimulation::LaunchProjectile(const FVector& Origin, const FVector& Velocity, float GravityScale, float Drag, float LifeSpan, AShooterCharacter* ProjectileInstigator)
+{
+	if (Projectiles.Num() >= MaxProjectiles) {
+		return false;
+	}
+
+	FProjectileState& Projectile = Projectiles.AddDefaulted_GetRef();
+	Projectile.Position = Origin;
+	Projectile.Velocity = Velocity;
+	Projectile.Origin = Origin;
+	Projectile.GravityZ = GetWorld()->GetGravityZ() * GravityScale;
+	Projectile.Drag = Drag;
+	Projectile.Age = 0.0f;
+	Projectile.LifeSpan = LifeSpan;
+	Projectile.IgnoredActor = nullptr;
+	Projectile.bAlive = true;
+
+	Instigators.Add(ProjectileInstigator);
+	return true;
+}
+
+// Called every frame
+void AProjectileSimulation::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	const float StepTime = 1.0f / StepRate;
+	StepAccumulator += DeltaTime;
+
+	int32 Steps = 0;
+	while (StepAccumulator >= StepTime && Steps < MaxStepsPerTick) {
+		StepProjectiles(StepTime);
+		StepAccumulator -= StepTime;
+		++Steps;
+	}
+
+	//Drop the time we could not catch up on
+	if (Steps == MaxStepsPerTick) {
+		StepAccumulator = FMath::Min(StepAccumulator, StepTime);
+	}
+
+	SET_DWORD_STAT(STAT_ProjectilesInFlight, Projectiles.Num());
+}
+
+void AProjectileSimulation::StepProjectiles(float StepTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_ProjectileStep);
+
+	const int32 NumProjectiles = Projectiles.Num();
+	if (NumProjectiles == 0) {
+		return;
+	}
+
+	//Resolve weak pointers here, the workers must not touch UObjects
+	for (int32 Index = 0; Index < NumProjectiles; ++Index) {
+		Projectiles[Index].IgnoredActor = Instigators[Index].Get();
+	}
+
+	UWorld* World = GetWorld();
+	StepImpacts.Reset();
+
+	//Integrate and sweep every projectile, one trace per projectile per step
+	ParallelFor(NumProjectiles, [this, World, StepTime](int32 Index)
+	{
+		FProjectileState& Projectile = Projectiles[Index];
+
+		const FVector Start = Projectile.Position;
+		const FVector Acceleration = FVector(0.0f, 0.0f, Projectile.GravityZ) - Projectile.Velocity * (Projectile.Drag * Projectile.Velocity.Size());
+		Projectile.Velocity += Acceleration * StepTime;
+		Projectile.Position += Projectile.Velocity * StepTime;
+		Projectile.Age += StepTime;
+
+		FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(ProjectileTrace), false, Projectile.IgnoredActor);
+		FHitResult Hit;
+		if (World->LineTraceSingleByChannel(Hit, Start, Projectile.Position, ECollisionChannel::ECC_Visibility, QueryParams)) {
+			Projectile.bAlive = false;
+
+			FScopeLock Lock(&StepImpactsLock);
+			StepImpacts.Add({ Index, MoveTemp(Hit) });
+		}
+		else if (Projectile.Age >= Projectile.LifeSpan) {
+			Projectile.bAlive = false;
+		}
+	}, NumProjectiles < MinParallelProjectiles);
+
+	//Workers add impacts in scheduling order, sort them so they are handled the same way every run
+	StepImpacts.Sort([](const FProjectileImpact& A, const FProjectileImpact& B) { return A.Index < B.Index; });
+
+	//Impacts go through the same effects path as hitscan shots
+	for (const FProjectileImpact& Impact : StepImpacts) {
+		if (AShooterCharacter* ShooterCharacter = Instigators[Impact.Index].Get()) {
+			ShooterCharacter->OnProjectileImpact(Projectiles[Impact.Index].Origin, Impact.Hit);
+		}
+	}
+
+	//Compact the pool, swapping dead projectiles out from the back
+	for (int32 Index = NumProjectiles - 1; Index >= 0; --Index) {
+		if (!Projectiles[Index].bAlive) {
+			Projectiles.RemoveAtSwap(Index, 1, false);
+			Instigators.RemoveAtSwap(Index, 1, false);
+		}
+	}
+}
@@ -0,0 +1,101 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "ProjectileSimulation.generated.h"
+
+class AShooterCharacter;
+
+// State of one in-flight projectile, kept in a contiguous array
+struct FProjectileState
+{
+	FVector Position;
+	FVector Velocity;
+
+	// Muzzle location the projectile was fired from
+	FVector Origin;
+
+	float GravityZ;
+
+	// Quadratic drag coefficient, deceleration is Drag * Speed^2
+	float Drag;
+
+	float Age;
+	float LifeSpan;
+
+	// Actor the swept trace ignores, resolved on the game thread before each step
+	const AActor* IgnoredActor;
+
+	bool bAlive;
+};
+
+// A projectile that hit something during the current step
+struct FProjectileImpact
+{
+	int32 Index;
+	FHitResult Hit;
+};
+
+/**
+ * Simulates projectile weapons without an actor per bullet.
+ * Projectiles are advanced at a fixed step on worker threads and swept with one trace each per step.
+ */
+UCLASS()
+class SHOOTER_API AProjectileSimulation : public AActor
+{
+	GENERATED_BODY()
+
+	friend class FProjectileSimulationBenchmarkTest;
+
+public:
+	// Sets default values for this actor's properties
+	AProjectileSimulation();
+
+	// Called every frame
+	virtual void Tick(float DeltaTime) override;
+
+	//Adds a projectile to the simulation, returns false if the pool is full
+	bool LaunchProjectile(const FVector& Origin, const FVector& Velocity, float GravityScale, float Drag, float LifeSpan, AShooterCharacter* ProjectileInstigator);
+
+	//Finds the simulation in the world, spawning one if the map has none
+	static AProjectileSimulation* Get(UWorld* World);
+
+	FORCEINLINE int32 GetNumProjectiles() const { return Projectiles.Num(); }
+
+protected:
+	// Called when the game starts or when spawned
+	virtual void BeginPlay() override;
+
+private:
+	//Integrates, sweeps and resolves every projectile by StepTime
+	void StepProjectiles(float StepTime);
+
+	//Simulation rate in steps per second
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Projectiles", meta = (AllowPrivateAccess = "true", ClampMin = "10"))
+	float StepRate;
+
+	//Steps allowed per frame before the simulation falls behind instead of spiralling
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Projectiles", meta = (AllowPrivateAccess = "true", ClampMin = "1"))
+	int32 MaxStepsPerTick;
+
+	//Projectiles allocated up front, launches beyond this are dropped
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Projectiles", meta = (AllowPrivateAccess = "true", ClampMin = "1"))
+	int32 MaxProjectiles;
+
+	//Below this many projectiles a step runs on the game thread only
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Projectiles", meta = (AllowPrivateAccess = "true", ClampMin = "1"))
+	int32 MinParallelProjectiles;
+
+	float StepAccumulator;
+
+	TArray<FProjectileState> Projectiles;
+
+	//Who fired each projectile, parallel to Projectiles
+	TArray<TWeakObjectPtr<AShooterCharacter>> Instigators;
+
+	//Impacts gathered by the worker threads during a step
+	TArray<FProjectileImpact> StepImpacts;
+	FCriticalSection StepImpactsLock;
+};
@@ -4,3 +4,20 @@
 
 #include "CoreMinimal.h"
 
+DECLARE_STATS_GROUP(TEXT("Shooter"), STATGROUP_Shooter, STATCAT_Advanced);
+
+// Cosmetic code (FX, audio, widgets, camera) is compiled out of the ShooterServer target
+#define WITH_SHOOTER_COSMETICS !UE_SERVER
+
+namespace ShooterCosmetics
+{
+	// True if this process renders and plays sound, false on dedicated servers
+	FORCEINLINE bool AreEnabled()
+	{
+#if WITH_SHOOTER_COSMETICS
+		return !IsRunningDedicatedServer();
+#else
+		return false;
+#endif
+	}
+}
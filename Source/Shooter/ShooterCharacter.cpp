@@ -1,6 +1,7 @@
 // Fill out your copyright notice in the Description page of Project Settings.
 
 #include "ShooterCharacter.h"
+#include "Shooter.h"
 #include "GameFramework/SpringArmComponent.h"
 #include "Camera/CameraComponent.h"
 #include "GameFramework/CharacterMovementComponent.h"
@@ -9,8 +10,45 @@
 #include "Engine/SkeletalMeshSocket.h"
 #include "Particles/ParticleSystemComponent.h"
 #include "Item.h"
+#include "Weapon.h"
+#include "WeaponPool.h"
 #include "Components/WidgetComponent.h"
+#include "ShooterHUD.h"
+#include "ProjectileSimulation.h"
+#include "Misc/App.h"
+#include "Async/ParallelFor.h"
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+#include "HAL/IConsoleManager.h"
+
+DECLARE_CYCLE_STAT(TEXT("Character Camera Tick"), STAT_ShooterCameraTick, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Character Spread Tick"), STAT_ShooterSpreadTick, STATGROUP_Shooter);
+DECLARE_CYCLE_STAT(TEXT("Character Item Trace Tick"), STAT_ShooterItemTraceTick, STATGROUP_Shooter);
+
+static TAutoConsoleVariable<int32> CVarShooterSplitCharacterTick(
+	TEXT("Shooter.SplitCharacterTick"),
+	1,
+	TEXT("1: run camera, spread and item trace as separate tick stages. 0: run them all from the actor tick, for before/after comparisons. Applies to characters spawned afterwards."),
+	ECVF_Default);
+
+void FShooterCharacterTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (Target && IsValid(Target) && !Target->IsUnreachable() && TickMethod) {
+		if (TickType != LEVELTICK_ViewportsOnly || Target->ShouldTickIfViewportsOnly()) {
+			(Target->*TickMethod)(DeltaTime * Target->CustomTimeDilation);
+		}
+	}
+}
 
+FString FShooterCharacterTickFunction::DiagnosticMessage()
+{
+	return Target ? FString::Printf(TEXT("%s[%s]"), *Target->GetFullName(), StageName) : FString(StageName);
+}
+
+FName FShooterCharacterTickFunction::DiagnosticContext(bool bDetailed)
+{
+	return Target ? Target->GetClass()->GetFName() : NAME_None;
+}
 
 // Sets default values for the ShooterCharacter class
 AShooterCharacter::AShooterCharacter() :
@@ -29,12 +67,44 @@ AShooterCharacter::AShooterCharacter() :
 	bFireButtonPressed(false), bShouldFire(true), AutomaticFireRate(0.1f),
 
 	//Item Trace Variables
-	bShouldTraceForItems(false)
+	bShouldTraceForItems(false), OverlappedItemCount(0), TraceHitItem(nullptr), TraceHitItemLastFrame(nullptr),
+
+	//Inventory variables
+	EquippedWeapon(nullptr), bSplitTickStages(true), ShotRandomSeed(0), ShotCounter(0), RecoilShotIndex(0), ProjectileSimulation(nullptr), InventoryCapacity(3),
+
+	//Replay variables
+	bHasNextPlaybackFrame(false), ExpectedReplayShotIndex(0), bUseFixedTimeStepBeforeReplay(false), FixedDeltaTimeBeforeReplay(0.0),
+	ReplayShotMismatches(0), ReplayTime(0.0)
 
 {
 	// Set this character to call Tick() every frame. You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = true;
 
+	// Camera zoom and sensitivity run after movement, on the game thread since they touch components
+	CameraTickFunction.bCanEverTick = true;
+	CameraTickFunction.TickGroup = TG_DuringPhysics;
+	CameraTickFunction.TickMethod = &AShooterCharacter::TickCamera;
+	CameraTickFunction.StageName = TEXT("Camera");
+
+	// Crosshair spread only reads movement state and writes our own floats, so it can run on a worker
+	SpreadTickFunction.bCanEverTick = true;
+	SpreadTickFunction.bRunOnAnyThread = true;
+	SpreadTickFunction.TickGroup = TG_DuringPhysics;
+	SpreadTickFunction.TickMethod = &AShooterCharacter::TickCrosshairSpread;
+	SpreadTickFunction.StageName = TEXT("Spread");
+
+	// Item trace runs once physics is done, and only while items are overlapped
+	ItemTraceTickFunction.bCanEverTick = true;
+	ItemTraceTickFunction.bStartWithTickEnabled = false;
+	ItemTraceTickFunction.TickGroup = TG_PostPhysics;
+	ItemTraceTickFunction.TickMethod = &AShooterCharacter::TickItemTrace;
+	ItemTraceTickFunction.StageName = TEXT("ItemTrace");
+
+#if !WITH_SHOOTER_COSMETICS
+	// Servers have no camera to zoom
+	CameraTickFunction.bCanEverTick = false;
+#endif
+
 	// Create a camera boom (pulls in towards the camera if there is a collision)
 	CameraBoom = CreateDefaultSubobject<USpringArmComponent>(TEXT("CameraBoom"));
 	CameraBoom->SetupAttachment(RootComponent);
@@ -68,6 +138,200 @@ void AShooterCharacter::BeginPlay() {
 		CameraDefaultFOV = GetFollowCamera()->FieldOfView;
 		CameraCurrentFOV = CameraDefaultFOV;
 	}
+
+	// Shots start at the weapon's barrel socket and hitboxes follow the pose, so servers keep animating the mesh
+	if (!ShooterCosmetics::AreEnabled()) {
+		GetMesh()->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
+	}
+
+	//Input (and replay playback) feed movement, movement feeds camera and spread, camera feeds the item trace
+	UCharacterMovementComponent* Movement = GetCharacterMovement();
+	Movement->PrimaryComponentTick.AddPrerequisite(this, PrimaryActorTick);
+	CameraTickFunction.AddPrerequisite(Movement, Movement->PrimaryComponentTick);
+	SpreadTickFunction.AddPrerequisite(Movement, Movement->PrimaryComponentTick);
+	ItemTraceTickFunction.AddPrerequisite(this, CameraTickFunction);
+	UpdateTickStages();
+
+	//Inventory never grows past its capacity, so allocate it once
+	Inventory.Reserve(InventoryCapacity);
+
+	SpawnDefaultWeapon();
+}
+
+void AShooterCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason) {
+	if (ReplayWriter) {
+		const double Minutes = FMath::Max(ReplayTime / 60.0, UE_DOUBLE_SMALL_NUMBER);
+		ReplayWriter->Close();
+		UE_LOG(LogTemp, Log, TEXT("Replay recorded: %d frames, %lld bytes, %.1f KB per minute"),
+			ReplayWriter->GetFramesWritten(), ReplayWriter->GetBytesWritten(), ReplayWriter->GetBytesWritten() / 1024.0 / Minutes);
+		ReplayWriter.Reset();
+	}
+
+	if (ReplayReader) {
+		FinishReplayPlayback();
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AShooterCharacter::InitReplay(APlayerController* PlayerController) {
+	if (PlayerController == nullptr || !PlayerController->IsLocalController() || ReplayWriter || ReplayReader) {
+		return;
+	}
+
+	FString FileName;
+	if (FParse::Value(FCommandLine::Get(), TEXT("ShooterReplay="), FileName)) {
+		ReplayReader = MakeUnique<FShooterReplayReader>();
+		if (!ReplayReader->Open(ShooterReplay::ResolveReplayPath(FileName))) {
+			ReplayReader.Reset();
+			return;
+		}
+
+		//Step the world with the recorded delta times so playback is reproducible
+		bUseFixedTimeStepBeforeReplay = FApp::UseFixedTimeStep();
+		FixedDeltaTimeBeforeReplay = FApp::GetFixedDeltaTime();
+		FApp::SetUseFixedTimeStep(true);
+		ReadNextPlaybackFrame();
+
+		//Inputs come from the replay only
+		DisableInput(PlayerController);
+		ReplayTime = FPlatformTime::Seconds();
+	}
+	else if (FParse::Value(FCommandLine::Get(), TEXT("ShooterRecord="), FileName)) {
+		ReplayWriter = MakeUnique<FShooterReplayWriter>();
+		if (!ReplayWriter->Open(ShooterReplay::ResolveReplayPath(FileName))) {
+			ReplayWriter.Reset();
+		}
+		ReplayTime = 0.0;
+	}
+}
+
+bool AShooterCharacter::ReadNextPlaybackFrame() {
+	bHasNextPlaybackFrame = ReplayReader->ReadFrame(NextPlaybackFrame);
+
+	//The record's delta time belongs to the frame it is played back in, which is the next engine frame
+	if (bHasNextPlaybackFrame) {
+		const double StepTime = NextPlaybackFrame.DeltaTime > 0.0f ? NextPlaybackFrame.DeltaTime : 1.0 / ReplayReader->GetFixedStepHz();
+		FApp::SetFixedDeltaTime(StepTime);
+	}
+	return bHasNextPlaybackFrame;
+}
+
+void AShooterCharacter::TickReplay(float DeltaTime) {
+	if (ReplayWriter) {
+		ReplayFrame.DeltaTime = DeltaTime;
+		ReplayWriter->WriteFrame(ReplayFrame);
+		ReplayTime += DeltaTime;
+	}
+	ReplayFrame.Reset();
+
+	if (ReplayReader) {
+		if (!bHasNextPlaybackFrame) {
+			FinishReplayPlayback();
+			return;
+		}
+		Swap(PlaybackFrame, NextPlaybackFrame);
+		ReadNextPlaybackFrame();
+
+		//Shots fired after last frame's tick (timers, projectile impacts) were recorded in this frame's record
+		ExpectedReplayShots.Append(PlaybackFrame.Shots);
+		CompareReplayShots();
+
+		//Replay button edges before axes, the same order the input component uses
+		if (EnumHasAnyFlags(PlaybackFrame.Buttons, EShooterReplayButton::JumpPressed)) {
+			JumpButtonPressed();
+		}
+		if (EnumHasAnyFlags(PlaybackFrame.Buttons, EShooterReplayButton::JumpReleased)) {
+			JumpButtonReleased();
+		}
+		if (EnumHasAnyFlags(PlaybackFrame.Buttons, EShooterReplayButton::AimPressed)) {
+			AimingButtonPressed();
+		}
+		if (EnumHasAnyFlags(PlaybackFrame.Buttons, EShooterReplayButton::AimReleased)) {
+			AimingButtonReleased();
+		}
+		if (EnumHasAnyFlags(PlaybackFrame.Buttons, EShooterReplayButton::FirePressed)) {
+			FireButtonPressed();
+		}
+		if (EnumHasAnyFlags(PlaybackFrame.Buttons, EShooterReplayButton::FireReleased)) {
+			FireButtonReleased();
+		}
+		if (EnumHasAnyFlags(PlaybackFrame.Buttons, EShooterReplayButton::Select)) {
+			SelectButtonPressed();
+		}
+		if (EnumHasAnyFlags(PlaybackFrame.Buttons, EShooterReplayButton::Drop)) {
+			DropButtonPressed();
+		}
+		if (EnumHasAnyFlags(PlaybackFrame.Buttons, EShooterReplayButton::NextWeapon)) {
+			NextWeaponButtonPressed();
+		}
+
+		MoveForward(PlaybackFrame.MoveForward);
+		MoveRight(PlaybackFrame.MoveRight);
+		TurnRate(PlaybackFrame.TurnRate);
+		LookUpRate(PlaybackFrame.LookUpRate);
+	}
+}
+
+void AShooterCharacter::CompareReplayShots() {
+	//Shots are compared in order, allowing for the quantization of the recording
+	const float Tolerance = 2.0f / ShooterReplay::LocationScale;
+
+	for (const FShooterReplayShot& Played : PlayedReplayShots) {
+		bool bMatches = false;
+
+		if (ExpectedReplayShots.IsValidIndex(ExpectedReplayShotIndex)) {
+			const FShooterReplayShot& Expected = ExpectedReplayShots[ExpectedReplayShotIndex++];
+			bMatches = Expected.bHit == Played.bHit && Expected.Start.Equals(Played.Start, Tolerance) && Expected.End.Equals(Played.End, Tolerance);
+		}
+
+		if (!bMatches) {
+			++ReplayShotMismatches;
+		}
+	}
+	PlayedReplayShots.Reset();
+
+	if (ExpectedReplayShotIndex >= ExpectedReplayShots.Num()) {
+		ExpectedReplayShots.Reset();
+		ExpectedReplayShotIndex = 0;
+	}
+}
+
+void AShooterCharacter::FinishReplayPlayback() {
+	//Match whatever was fired during the last frame, then recorded shots that were never fired count as mismatches too
+	CompareReplayShots();
+	ReplayShotMismatches += ExpectedReplayShots.Num() - ExpectedReplayShotIndex;
+
+	const int32 Frames = ReplayReader->GetFramesRead();
+	const double ElapsedMs = (FPlatformTime::Seconds() - ReplayTime) * 1000.0;
+	UE_LOG(LogTemp, Log, TEXT("Replay finished: %d frames, %.3f ms per frame, %d shot mismatches%s"),
+		Frames, Frames > 0 ? ElapsedMs / Frames : 0.0, ReplayShotMismatches, ReplayReader->IsCorrupt() ? TEXT(", file truncated") : TEXT(""));
+
+	ReplayReader.Reset();
+	bHasNextPlaybackFrame = false;
+	ExpectedReplayShots.Reset();
+	ExpectedReplayShotIndex = 0;
+
+	//Give the engine back its own time step
+	FApp::SetUseFixedTimeStep(bUseFixedTimeStepBeforeReplay);
+	FApp::SetFixedDeltaTime(FixedDeltaTimeBeforeReplay);
+
+	if (FParse::Param(FCommandLine::Get(), TEXT("ShooterReplayExit"))) {
+		FPlatformMisc::RequestExit(false);
+	}
+	else {
+		EnableInput(Cast<APlayerController>(Controller));
+	}
+}
+
+void AShooterCharacter::RecordReplayShot(const FVector& Start, const FVector& End, bool bHit) {
+	if (ReplayWriter) {
+		ReplayFrame.Shots.Add({ Start, End, bHit });
+	}
+	else if (ReplayReader) {
+		//Checked in CompareReplayShots once the record holding the matching shot has been read
+		PlayedReplayShots.Add({ Start, End, bHit });
+	}
 }
 
 // Called to bind functionality to input
@@ -83,61 +347,289 @@ void AShooterCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputCo
 	PlayerInputComponent->BindAxis("Turn", this, &AShooterCharacter::TurnRate);
 	PlayerInputComponent->BindAxis("LookUp", this, &AShooterCharacter::LookUpRate);
 
-	PlayerInputComponent->BindAction("Jump", IE_Pressed, this, &ACharacter::Jump);
-	PlayerInputComponent->BindAction("Jump", IE_Released, this, &ACharacter::StopJumping);
+	PlayerInputComponent->BindAction("Jump", IE_Pressed, this, &AShooterCharacter::JumpButtonPressed);
+	PlayerInputComponent->BindAction("Jump", IE_Released, this, &AShooterCharacter::JumpButtonReleased);
 
 	PlayerInputComponent->BindAction("FireButton", IE_Pressed, this, &AShooterCharacter::FireButtonPressed);
 	PlayerInputComponent->BindAction("FireButton", IE_Released, this, &AShooterCharacter::FireButtonReleased);
 
 	PlayerInputComponent->BindAction("AimingButton", IE_Pressed, this, &AShooterCharacter::AimingButtonPressed);
 	PlayerInputComponent->BindAction("AimingButton", IE_Released, this, &AShooterCharacter::AimingButtonReleased);
+
+	PlayerInputComponent->BindAction("Select", IE_Pressed, this, &AShooterCharacter::SelectButtonPressed);
+	PlayerInputComponent->BindAction("Drop", IE_Pressed, this, &AShooterCharacter::DropButtonPressed);
+	PlayerInputComponent->BindAction("NextWeapon", IE_Pressed, this, &AShooterCharacter::NextWeaponButtonPressed);
 }
 
-// Called every frame
+// Called every frame, before movement. Camera, spread and item tracing run in their own tick functions.
 void AShooterCharacter::Tick(float DeltaTime) {
 	Super::Tick(DeltaTime);
 
+	// Record this frame's input or feed in the next recorded frame
+	TickReplay(DeltaTime);
+
+	// Single tick path, every stage runs here for every character
+	if (!bSplitTickStages) {
+		TickCamera(DeltaTime);
+		TickCrosshairSpread(DeltaTime);
+		TickItemTrace(DeltaTime);
+	}
+}
+
+void AShooterCharacter::RegisterActorTickFunctions(bool bRegister) {
+	Super::RegisterActorTickFunctions(bRegister);
+
+	if (bRegister) {
+		bSplitTickStages = CVarShooterSplitCharacterTick.GetValueOnGameThread() != 0;
+	}
+
+	for (FShooterCharacterTickFunction* TickFunction : { &CameraTickFunction, &SpreadTickFunction, &ItemTraceTickFunction }) {
+		if (bRegister) {
+			if (TickFunction->bCanEverTick && bSplitTickStages) {
+				TickFunction->Target = this;
+				TickFunction->SetTickFunctionEnable(TickFunction->bStartWithTickEnabled || TickFunction->IsTickFunctionEnabled());
+				TickFunction->RegisterTickFunction(GetLevel());
+			}
+		}
+		else if (TickFunction->IsTickFunctionRegistered()) {
+			TickFunction->UnRegisterTickFunction();
+		}
+	}
+}
+
+void AShooterCharacter::NotifyControllerChanged() {
+	Super::NotifyControllerChanged();
+
+	UpdateTickStages();
+
+	// Runs on the owning client as well as the server, unlike PossessedBy
+	InitReplay(Cast<APlayerController>(Controller));
+}
+
+void AShooterCharacter::UpdateTickStages() {
+	const bool bLocalPlayer = IsLocallyControlled() && IsPlayerControlled();
+
+	// Nobody looks through the camera or at the pickup prompt of other characters
+	CameraTickFunction.SetTickFunctionEnable(bLocalPlayer && ShooterCosmetics::AreEnabled());
+	ItemTraceTickFunction.SetTickFunctionEnable(bLocalPlayer && bShouldTraceForItems);
+}
+
+void AShooterCharacter::TickCamera(float DeltaTime) {
+	SCOPE_CYCLE_COUNTER(STAT_ShooterCameraTick);
+
 	// Handle interpolation for zoom when aiming
 	CameraInterpZoom(DeltaTime);
 
 	// Adjust sensitivity based on aiming state
 	SensitivitySetting();
+}
 
-	// Calculate crosshair spread multiplier
+void AShooterCharacter::TickCrosshairSpread(float DeltaTime) {
+	SCOPE_CYCLE_COUNTER(STAT_ShooterSpreadTick);
+
+	// Calculate crosshair spread multiplier from this frame's velocity
 	CalculateCrosshairSpread(DeltaTime);
+}
+
+void AShooterCharacter::TickItemTrace(float DeltaTime) {
+	SCOPE_CYCLE_COUNTER(STAT_ShooterItemTraceTick);
+
+	//Check OverlappedItemCount then trace for items
+	TraceForItems();
+}
+
+void AShooterCharacter::TraceForItems() {
+	TraceHitItem = nullptr;
 
 	if (bShouldTraceForItems) {
-		FHitResult WeaponTraceResult;
+		FHitResult ItemTraceResult;
 		FVector HitLocation;
-		TraceUnderCrosshairs(WeaponTraceResult, HitLocation);
-		if (WeaponTraceResult.GetActor()) {
-			AItem* HitItem = Cast<AItem>(WeaponTraceResult.GetActor());
+		TraceUnderCrosshairs(ItemTraceResult, HitLocation);
+		if (ItemTraceResult.bBlockingHit) {
+			TraceHitItem = Cast<AItem>(ItemTraceResult.GetActor());
 
-			if (HitItem && HitItem->GetPickupWidget()) {
-				//Show Item Pickup Widget
-				HitItem->GetPickupWidget()->SetVisibility(true);
+			if (TraceHitItem && TraceHitItem->GetPickupWidget()) {
+				//Show the item's own pickup widget if it has one
+				TraceHitItem->GetPickupWidget()->SetVisibility(true);
 			}
 		}
 	}
+
+	//Hide the widget of the item we were looking at last frame
+	if (TraceHitItemLastFrame && TraceHitItemLastFrame != TraceHitItem && TraceHitItemLastFrame->GetPickupWidget()) {
+		TraceHitItemLastFrame->GetPickupWidget()->SetVisibility(false);
+	}
+
+	//Point the shared HUD prompt at the focused item
+	if (TraceHitItem != TraceHitItemLastFrame) {
+		if (AShooterHUD* ShooterHUD = GetShooterHUD()) {
+			const bool bUseSharedPrompt = TraceHitItem && TraceHitItem->GetPickupWidget() == nullptr;
+			ShooterHUD->SetFocusedItem(bUseSharedPrompt ? TraceHitItem : nullptr);
+		}
+	}
+	TraceHitItemLastFrame = TraceHitItem;
+}
+
+AShooterHUD* AShooterCharacter::GetShooterHUD() const {
+	const APlayerController* PlayerController = Cast<APlayerController>(Controller);
+	return PlayerController ? Cast<AShooterHUD>(PlayerController->GetHUD()) : nullptr;
+}
+
+void AShooterCharacter::IncrementOverlappedItemCount(int32 Amount) {
+	OverlappedItemCount = FMath::Max(OverlappedItemCount + Amount, 0);
+	bShouldTraceForItems = OverlappedItemCount > 0;
+
+	// The item trace stage only ticks while something is overlapped, so clear the prompt now
+	if (!bShouldTraceForItems) {
+		TraceForItems();
+	}
+	UpdateTickStages();
+}
+
+void AShooterCharacter::SpawnDefaultWeapon() {
+	if (DefaultWeaponClass == nullptr) {
+		return;
+	}
+
+	AWeapon* DefaultWeapon = nullptr;
+	if (AWeaponPool* Pool = AWeaponPool::FindPool(GetWorld(), DefaultWeaponClass)) {
+		DefaultWeapon = Pool->AcquireWeapon(GetActorTransform());
+	}
+	else {
+		DefaultWeapon = GetWorld()->SpawnActor<AWeapon>(DefaultWeaponClass, GetActorTransform());
+	}
+
+	PickupItem(DefaultWeapon);
+}
+
+void AShooterCharacter::PickupItem(AItem* Item) {
+	AWeapon* Weapon = Cast<AWeapon>(Item);
+	if (Weapon == nullptr || Weapon->GetItemState() != EItemState::EIS_Pickup) {
+		return;
+	}
+
+	//Make room by dropping the equipped weapon when the inventory is full
+	if (Inventory.Num() >= InventoryCapacity) {
+		DropWeapon();
+	}
+
+	Weapon->ClearDroppedLifeSpan();
+	Inventory.Add(Weapon);
+	EquipWeapon(Weapon);
+}
+
+void AShooterCharacter::EquipWeapon(AWeapon* WeaponToEquip) {
+	if (WeaponToEquip == nullptr) {
+		return;
+	}
+
+	//Stow the weapon that was in our hands
+	if (EquippedWeapon && EquippedWeapon != WeaponToEquip) {
+		EquippedWeapon->SetItemState(EItemState::EIS_PickedUp);
+	}
+
+	const USkeletalMeshSocket* HandSocket = GetMesh()->GetSocketByName(FName("RightHandSocket"));
+	if (HandSocket) {
+		HandSocket->AttachActor(WeaponToEquip, GetMesh());
+	}
+
+	WeaponToEquip->SetItemState(EItemState::EIS_Equipped);
+	EquippedWeapon = WeaponToEquip;
+}
+
+void AShooterCharacter::DropWeapon() {
+	if (EquippedWeapon == nullptr) {
+		return;
+	}
+
+	AWeapon* DroppedWeapon = EquippedWeapon;
+	Inventory.RemoveSingleSwap(DroppedWeapon, false);
+	EquippedWeapon = nullptr;
+
+	DroppedWeapon->DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+
+	//Place the weapon on the ground in front of the character
+	FCollisionQueryParams QueryParams;
+	QueryParams.AddIgnoredActor(this);
+	QueryParams.AddIgnoredActor(DroppedWeapon);
+
+	const FVector DropStart = GetActorLocation() + GetActorForwardVector() * 100.0f;
+	const FVector DropEnd = DropStart - FVector(0.0f, 0.0f, 1'000.0f);
+	FHitResult FloorHit;
+	const bool bHitFloor = GetWorld()->LineTraceSingleByChannel(FloorHit, DropStart, DropEnd, ECollisionChannel::ECC_Visibility, QueryParams);
+
+	const FRotator DropRotation(0.0f, GetActorRotation().Yaw, 0.0f);
+	DroppedWeapon->SetActorLocationAndRotation(bHitFloor ? FloorHit.Location : DropStart, DropRotation, false, nullptr, ETeleportType::TeleportPhysics);
+	DroppedWeapon->SetItemState(EItemState::EIS_Pickup);
+	DroppedWeapon->StartDroppedLifeSpan();
+
+	//Fall back to another weapon we are still carrying
+	if (Inventory.Num() > 0) {
+		EquipWeapon(Inventory[0]);
+	}
+}
+
+void AShooterCharacter::CycleWeapon() {
+	if (Inventory.Num() < 2) {
+		return;
+	}
+
+	const int32 CurrentIndex = Inventory.Find(EquippedWeapon);
+	EquipWeapon(Inventory[(CurrentIndex + 1) % Inventory.Num()]);
+}
+
+void AShooterCharacter::SelectButtonPressed() {
+	ReplayFrame.Buttons |= EShooterReplayButton::Select;
+	if (TraceHitItem) {
+		PickupItem(TraceHitItem);
+		TraceHitItem = nullptr;
+	}
+}
+
+void AShooterCharacter::DropButtonPressed() {
+	ReplayFrame.Buttons |= EShooterReplayButton::Drop;
+	DropWeapon();
+}
+
+void AShooterCharacter::NextWeaponButtonPressed() {
+	ReplayFrame.Buttons |= EShooterReplayButton::NextWeapon;
+	CycleWeapon();
 }
 
 // Function to handle when the aiming button is pressed
 void AShooterCharacter::AimingButtonPressed() {
+	ReplayFrame.Buttons |= EShooterReplayButton::AimPressed;
 	bAiming =true;
 }
 
 // Function to handle when the aiming button is released
 void AShooterCharacter::AimingButtonReleased() {
+	ReplayFrame.Buttons |= EShooterReplayButton::AimReleased;
 	bAiming = false;
 }
 
+void AShooterCharacter::JumpButtonPressed() {
+	ReplayFrame.Buttons |= EShooterReplayButton::JumpPressed;
+	Jump();
+}
+
+void AShooterCharacter::JumpButtonReleased() {
+	ReplayFrame.Buttons |= EShooterReplayButton::JumpReleased;
+	StopJumping();
+}
+
 void AShooterCharacter::FireButtonPressed() {
+	ReplayFrame.Buttons |= EShooterReplayButton::FirePressed;
 	bFireButtonPressed = true;
 	StartFireTimer();
 }
 
 void AShooterCharacter::FireButtonReleased() {
+	ReplayFrame.Buttons |= EShooterReplayButton::FireReleased;
 	bFireButtonPressed = false;
+
+	//Next burst starts at the beginning of the recoil pattern
+	RecoilShotIndex = 0;
 }
 
 void AShooterCharacter::StartFireTimer() {
@@ -212,9 +704,9 @@ void AShooterCharacter::CalculateCrosshairSpread(float DeltaTime) {
 	}
 	else {
 		CrosshairShootingFactor = FMath::FInterpTo(CrosshairShootingFactor, 0.0f, DeltaTime, 60.0f);
-
-		CrosshairSpreadMultiplier = 0.5f + CrosshairVelocityFactor + CrosshairInAirFactor + CrosshairAimingFactor + CrosshairShootingFactor;
 	}
+
+	CrosshairSpreadMultiplier = 0.5f + CrosshairVelocityFactor + CrosshairInAirFactor + CrosshairAimingFactor + CrosshairShootingFactor;
 }
 
 void AShooterCharacter::StartCrosshairBulletFire() {
@@ -228,63 +720,134 @@ void AShooterCharacter::FinishCrosshairBulletFire() {
 }
 
 bool AShooterCharacter::TraceUnderCrosshairs(FHitResult& OutHitResult, FVector& OutHitLocation) {
-	//Get Viewport Size
-	FVector2D ViewportSize;
-
-	if (GEngine && GEngine->GameViewport) {
-		GEngine->GameViewport->GetViewportSize(ViewportSize);
-	}
-
-	// Get Screen Space Location of Cross-hairs
-	FVector2D CrosshairLocation(ViewportSize.X / 2.0f, ViewportSize.Y / 2.0f);
-	CrosshairLocation.Y -= 50.0f; // Adjust the vertical position of the crosshair
 	FVector CrosshairWorldPosition;
 	FVector CrosshairWorldDirection;
+	bool bScreenToWorld = false;
+
+	// Only a local player has a viewport with a crosshair, and it must be our own controller's
+	APlayerController* PlayerController = Cast<APlayerController>(Controller);
+	if (PlayerController && PlayerController->IsLocalController()) {
+		//Get Viewport Size
+		int32 ViewportSizeX = 0;
+		int32 ViewportSizeY = 0;
+		PlayerController->GetViewportSize(ViewportSizeX, ViewportSizeY);
+
+		// Get Screen Space Location of Cross-hairs
+		FVector2D CrosshairLocation(ViewportSizeX / 2.0f, ViewportSizeY / 2.0f);
+		CrosshairLocation.Y -= 50.0f; // Adjust the vertical position of the crosshair
+
+		// Convert screen space crosshair location to world space
+		bScreenToWorld = ViewportSizeX > 0 && ViewportSizeY > 0 &&
+			UGameplayStatics::DeprojectScreenToWorld(PlayerController, CrosshairLocation, CrosshairWorldPosition, CrosshairWorldDirection);
+	}
 
-	// Convert screen space crosshair location to world space
-	bool bScreenToWorld = UGameplayStatics::DeprojectScreenToWorld(UGameplayStatics::GetPlayerController(this, 0), CrosshairLocation,
-		CrosshairWorldPosition, CrosshairWorldDirection);
+	if (!bScreenToWorld) {
+		// Servers, bots and headless sessions aim along the controller's view point instead
+		FRotator ViewRotation;
+		GetActorEyesViewPoint(CrosshairWorldPosition, ViewRotation);
+		CrosshairWorldDirection = ViewRotation.Vector();
+	}
 
-	if (bScreenToWorld) {
-		//Line trace from crosshairs world location
-		const FVector Start = CrosshairWorldPosition;
-		const FVector End = Start + CrosshairWorldDirection * 50'000.0f;
-		OutHitLocation = End;
+	//Line trace from crosshairs world location
+	const FVector Start = CrosshairWorldPosition;
+	const FVector End = Start + CrosshairWorldDirection * 50'000.0f;
+	OutHitLocation = End;
 
-		GetWorld()->LineTraceSingleByChannel(OutHitResult, Start, End, ECollisionChannel::ECC_Visibility);
+	GetWorld()->LineTraceSingleByChannel(OutHitResult, Start, End, ECollisionChannel::ECC_Visibility);
 
-		if (OutHitResult.bBlockingHit) {
-			OutHitLocation = OutHitResult.Location;
-			return true;
-		}
+	if (OutHitResult.bBlockingHit) {
+		OutHitLocation = OutHitResult.Location;
+		return true;
 	}
 	return false;
 }
 
-// Function to get the end location of the beam
-bool AShooterCharacter::GetBeamEndLocation(const FVector& MuzzleSocketLocation, FVector& OutBeamLocation)
+// Function to get the direction of every pellet of the next shot
+float AShooterCharacter::GetShotDirections(const FVector& MuzzleSocketLocation)
 {
+	// One crosshair trace is shared by every pellet
 	FHitResult CrosshairHitResult;
-	bool bCrosshairHit = TraceUnderCrosshairs(CrosshairHitResult, OutBeamLocation); //Check for crosshair trace hit
+	FVector AimLocation = FVector::ZeroVector;
+	TraceUnderCrosshairs(CrosshairHitResult, AimLocation); //AimLocation is the hit or the end of the trace
+
+	const FVector StartToEnd = AimLocation - MuzzleSocketLocation;
+
+	// Scatter the pellets around the aim direction, the same seed and shot count always give the same pattern
+	const AWeapon* Weapon = EquippedWeapon ? EquippedWeapon : GetDefault<AWeapon>();
+	const int32 ShotSeed = static_cast<int32>(HashCombine(static_cast<uint32>(ShotRandomSeed), static_cast<uint32>(ShotCounter++)));
+	Weapon->GetPelletDirections(StartToEnd.GetSafeNormal(), CrosshairSpreadMultiplier, ShotSeed, PelletDirections);
+
+	return StartToEnd.Size() * 1.25f;
+}
+
+// Function to get the end location of the beam for every pellet
+bool AShooterCharacter::GetBeamEndLocations(const FVector& MuzzleSocketLocation, TArray<FHitResult>& OutPelletHits)
+{
+	const float TraceLength = GetShotDirections(MuzzleSocketLocation);
 
-	if (bCrosshairHit) {
-		//Tentative beam location - still need to trace under gun
-		OutBeamLocation = CrosshairHitResult.Location;
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(WeaponTrace));
+	QueryParams.AddIgnoredActor(this);
+	if (EquippedWeapon) {
+		QueryParams.AddIgnoredActor(EquippedWeapon);
 	}
-	else {//No crosshair hit
-		//OutBeamLocation is the end location for the line trace
+
+	// Trace all pellets from the gun barrel as one batch, each pellet writes only its own hit
+	UWorld* World = GetWorld();
+	const int32 NumPellets = PelletDirections.Num();
+	OutPelletHits.Reset(NumPellets);
+	OutPelletHits.SetNum(NumPellets);
+	ParallelFor(NumPellets, [this, World, &MuzzleSocketLocation, &QueryParams, &OutPelletHits, TraceLength](int32 Index)
+	{
+		FHitResult& WeaponTraceHit = OutPelletHits[Index];
+		const FVector WeaponTraceEnd = MuzzleSocketLocation + PelletDirections[Index] * TraceLength;
+		World->LineTraceSingleByChannel(WeaponTraceHit, MuzzleSocketLocation, WeaponTraceEnd, ECollisionChannel::ECC_Visibility, QueryParams);
+
+		if (!WeaponTraceHit.bBlockingHit) {
+			WeaponTraceHit.Location = WeaponTraceEnd;
+		}
+	}, NumPellets < 2);
+
+	return OutPelletHits.ContainsByPredicate([](const FHitResult& PelletHit) { return PelletHit.bBlockingHit; });
+}
+
+void AShooterCharacter::LaunchProjectiles(const FVector& MuzzleSocketLocation) {
+	if (ProjectileSimulation == nullptr) {
+		ProjectileSimulation = AProjectileSimulation::Get(GetWorld());
+		if (ProjectileSimulation == nullptr) {
+			return;
+		}
 	}
-	// Perform a second trace from the gun barrel
-	FHitResult WeaponTraceHit;
-	const FVector WeaponTraceStart = MuzzleSocketLocation;
-	const FVector StartToEnd = OutBeamLocation - MuzzleSocketLocation;
-	const FVector WeaponTraceEnd = MuzzleSocketLocation + StartToEnd * 1.25f;
-	GetWorld()->LineTraceSingleByChannel(WeaponTraceHit, WeaponTraceStart, WeaponTraceEnd, ECollisionChannel::ECC_Visibility);
 
-	if (WeaponTraceHit.bBlockingHit) { // Object between barrel and cross-hair
-		OutBeamLocation = WeaponTraceHit.Location;
-		return true;
-	} return false;
+	GetShotDirections(MuzzleSocketLocation);
+	for (const FVector& Direction : PelletDirections) {
+		ProjectileSimulation->LaunchProjectile(MuzzleSocketLocation, Direction * EquippedWeapon->GetProjectileSpeed(),
+			EquippedWeapon->GetProjectileGravityScale(), EquippedWeapon->GetProjectileDrag(), EquippedWeapon->GetProjectileLifeSpan(), this);
+	}
+}
+
+void AShooterCharacter::OnProjectileImpact(const FVector& Origin, const FHitResult& Hit) {
+	RecordReplayShot(Origin, Hit.Location, true);
+	PlayImpactEffects(Hit.Location);
+}
+
+void AShooterCharacter::PlayImpactEffects(const FVector& ImpactLocation) {
+#if WITH_SHOOTER_COSMETICS
+	// Spawn impact particles at the end of the beam
+	if (ImpactParticles && ShooterCosmetics::AreEnabled()) {
+		UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ImpactParticles, ImpactLocation);
+	}
+#endif
+}
+
+void AShooterCharacter::ApplyRecoil() {
+	if (EquippedWeapon == nullptr || Controller == nullptr) {
+		return;
+	}
+
+	const FVector2D Kick = EquippedWeapon->GetRecoilKick(RecoilShotIndex++);
+	if (!Kick.IsZero()) {
+		Controller->SetControlRotation(Controller->GetControlRotation() + FRotator(Kick.X, Kick.Y, 0.0f));
+	}
 }
  
 // Function to get the current crosshair spread multiplier
@@ -294,6 +857,7 @@ float AShooterCharacter::GetCrosshairSpreadMultiplier() const {
 
 // Function to handle character movement forward
 void AShooterCharacter::MoveForward(float Value) {
+	ReplayFrame.MoveForward = Value;
 	if ((Controller != nullptr) && (Value != 0.0f)) {
 		const FRotator Rotation = Controller->GetControlRotation();
 		const FRotator YawRotation(0, Rotation.Yaw, 0);
@@ -305,6 +869,7 @@ void AShooterCharacter::MoveForward(float Value) {
 
 // Function to handle character movement to the right
 void AShooterCharacter::MoveRight(float Value) {
+	ReplayFrame.MoveRight = Value;
 	if ((Controller != nullptr) && (Value != 0.0f)) {
 		const FRotator Rotation = Controller->GetControlRotation();
 		const FRotator YawRotation(0, Rotation.Yaw, 0);
@@ -316,12 +881,14 @@ void AShooterCharacter::MoveRight(float Value) {
 
 // Function to handle looking up with the specified rate
 void AShooterCharacter::LookUpRate(float Value) {
+	ReplayFrame.LookUpRate = Value;
 	// Adjust the pitch of the controller based on input and sensitivity
 	APawn::AddControllerPitchInput(Value *CurrentAimSensitivity);
 }
 
 // Function to handle turning with the specified rate
 void AShooterCharacter::TurnRate(float Value) {
+	ReplayFrame.TurnRate = Value;
 	// Adjust the yaw of the controller based on input and sensitivity
 	APawn::AddControllerYawInput(Value *CurrentAimSensitivity);
 }
@@ -330,31 +897,54 @@ void AShooterCharacter::TurnRate(float Value) {
 
 
 void AShooterCharacter::FireWeapon() {
-	// Play the fire sound if available
-	if (FireSound) {
-		UGameplayStatics::PlaySound2D(this, FireSound);
-	}
-
-	// Get the barrel socket for spawning effects
-	const USkeletalMeshSocket* BarrelSocket = GetMesh()->GetSocketByName("BarrelSocket");
+	// Get the barrel socket for spawning effects, from the equipped weapon if we hold one
+	USkeletalMeshComponent* BarrelMesh = EquippedWeapon ? EquippedWeapon->GetItemMesh() : GetMesh();
+	const USkeletalMeshSocket* BarrelSocket = BarrelMesh->GetSocketByName("BarrelSocket");
 
 	if (BarrelSocket) {
 		// Get the transformation of the barrel socket
-		const FTransform SocketTransform = BarrelSocket->GetSocketTransform(GetMesh());
+		const FTransform SocketTransform = BarrelSocket->GetSocketTransform(BarrelMesh);
 
-		// Spawn the muzzle flash effect
-		if (MuzzleFlash) {
-			UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), MuzzleFlash, SocketTransform);
+		if (EquippedWeapon && EquippedWeapon->GetFireMode() == EWeaponFireMode::EFM_Projectile) {
+			// Impacts are reported back through OnProjectileImpact
+			LaunchProjectiles(SocketTransform.GetLocation());
+			PelletHits.Reset();
+		}
+		else {
+			GetBeamEndLocations(SocketTransform.GetLocation(), PelletHits);
 		}
 
-		FVector BeamEnd;
-		bool bBeamEnd = GetBeamEndLocation(SocketTransform.GetLocation(), BeamEnd);
+		for (const FHitResult& PelletHit : PelletHits) {
+			RecordReplayShot(SocketTransform.GetLocation(), PelletHit.Location, PelletHit.bBlockingHit);
+		}
 
-		if (bBeamEnd) {
-			// Spawn impact particles at the end of the beam
-			if (ImpactParticles) {
-				UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), ImpactParticles, BeamEnd);
-			}
+		PlayFireEffects(SocketTransform);
+	}
+
+	// Kick the camera by the weapon's recoil pattern
+	ApplyRecoil();
+
+	PlayFireSoundAndMontage();
+
+	//Start bullet fire timer for crosshairs
+	StartCrosshairBulletFire();
+}
+
+void AShooterCharacter::PlayFireEffects(const FTransform& SocketTransform) {
+#if WITH_SHOOTER_COSMETICS
+	if (!ShooterCosmetics::AreEnabled()) {
+		return;
+	}
+
+	// Spawn the muzzle flash effect
+	if (MuzzleFlash) {
+		UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), MuzzleFlash, SocketTransform);
+	}
+
+	for (const FHitResult& PelletHit : PelletHits) {
+		if (PelletHit.bBlockingHit) {
+			const FVector BeamEnd = PelletHit.Location;
+			PlayImpactEffects(BeamEnd);
 
 			// Spawn the beam effect and set its target
 			UParticleSystemComponent* Beam = UGameplayStatics::SpawnEmitterAtLocation(GetWorld(), BeamParticles, SocketTransform);
@@ -363,6 +953,19 @@ void AShooterCharacter::FireWeapon() {
 			}
 		}
 	}
+#endif
+}
+
+void AShooterCharacter::PlayFireSoundAndMontage() {
+#if WITH_SHOOTER_COSMETICS
+	if (!ShooterCosmetics::AreEnabled()) {
+		return;
+	}
+
+	// Play the fire sound if available
+	if (FireSound) {
+		UGameplayStatics::PlaySound2D(this, FireSound);
+	}
 
 	// Play the hip-fire animation montage
 	UAnimInstance* AnimInstance = GetMesh()->GetAnimInstance();
@@ -370,8 +973,6 @@ void AShooterCharacter::FireWeapon() {
 		AnimInstance->Montage_Play(HipFireMontage);
 		AnimInstance->Montage_JumpToSection(FName("StartFire"));
 	}
-
-	//Start bullet fire timer for crosshairs
-	StartCrosshairBulletFire();
+#endif
 }
 
@@ -4,13 +4,40 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
+#include "ShooterReplay.h"
 #include "ShooterCharacter.generated.h"
 
+class AItem;
+class AWeapon;
+class AShooterCharacter;
+
+/**
+ * Runs one stage of the character's per-frame work as its own tick function,
+ * so each stage can have its own tick group, prerequisites and thread.
+ */
+struct FShooterCharacterTickFunction : public FTickFunction
+{
+    AShooterCharacter* Target = nullptr;
+
+    // Member function called when this tick function runs
+    void (AShooterCharacter::*TickMethod)(float DeltaTime) = nullptr;
+
+    // Shown in tick diagnostics
+    const TCHAR* StageName = TEXT("");
+
+    virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+    virtual FString DiagnosticMessage() override;
+    virtual FName DiagnosticContext(bool bDetailed) override;
+};
+
 UCLASS()
 class SHOOTER_API AShooterCharacter : public ACharacter
 {
     GENERATED_BODY()
 
+    friend class FWeaponPoolStressTest;
+    friend class FShooterCharacterTickBenchmarkTest;
+
 public:
     // Sets default values for this character's properties
     AShooterCharacter();
@@ -19,6 +46,12 @@ protected:
     // Called when the game starts or when spawned
     virtual void BeginPlay() override;
 
+    virtual void RegisterActorTickFunctions(bool bRegister) override;
+
+    virtual void NotifyControllerChanged() override;
+
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
     /* Called for forward and backward movement */
     void MoveForward(float Value);
 
@@ -32,7 +65,26 @@ protected:
 
     void FireWeapon(); // Called when the fire button is clicked
 
-    bool GetBeamEndLocation(const FVector& MuzzleSocketLocation, FVector& OutBeamLocation);
+    //Fills PelletDirections for the next shot, scattered around the crosshair by the spread. Returns the trace length.
+    float GetShotDirections(const FVector& MuzzleSocketLocation);
+
+    //Traces every pellet of a shot from the barrel, scattered by the crosshair spread. Returns true if any pellet hit.
+    bool GetBeamEndLocations(const FVector& MuzzleSocketLocation, TArray<FHitResult>& OutPelletHits);
+
+    //Hands every pellet of a shot to the projectile simulation
+    void LaunchProjectiles(const FVector& MuzzleSocketLocation);
+
+    //Impact particles shared by hitscan and projectile hits
+    void PlayImpactEffects(const FVector& ImpactLocation);
+
+    //Muzzle flash, beams and impacts for the pellets in PelletHits, skipped on servers
+    void PlayFireEffects(const FTransform& SocketTransform);
+
+    //Gunshot sound and hip-fire montage, skipped on servers
+    void PlayFireSoundAndMontage();
+
+    //Kicks the control rotation by the equipped weapon's recoil pattern
+    void ApplyRecoil();
 
     // Set bAiming to true or false with button press
     void AimingButtonPressed();
@@ -41,6 +93,9 @@ protected:
     void FireButtonPressed();
     void FireButtonReleased();
 
+    void JumpButtonPressed();
+    void JumpButtonReleased();
+
     void StartFireTimer();
 
     UFUNCTION()
@@ -52,6 +107,18 @@ protected:
     // Interpolate camera zoom FOV
     void CameraInterpZoom(float DeltaTime);
 
+    // Tick stage after movement: camera zoom and aim sensitivity, game thread
+    void TickCamera(float DeltaTime);
+
+    // Tick stage after movement: crosshair spread, may run on a worker thread
+    void TickCrosshairSpread(float DeltaTime);
+
+    // Tick stage in TG_PostPhysics: item trace for the local player
+    void TickItemTrace(float DeltaTime);
+
+    // Enables the camera and item trace stages only for the locally controlled player
+    void UpdateTickStages();
+
     // Calculate crosshair spread based on various factors
     void CalculateCrosshairSpread(float DeltaTime);
 
@@ -63,6 +130,49 @@ protected:
     //Line trace for items under the crosshair
     bool TraceUnderCrosshairs(FHitResult& OutHitResult, FVector& OutHitLocation);
 
+    //Trace for items if OverlappedItemCount > 0 and show the pickup prompt for the one under the crosshair
+    void TraceForItems();
+
+    //HUD of the local player controlling this character, null otherwise
+    class AShooterHUD* GetShooterHUD() const;
+
+    //Takes the default weapon from its pool (or spawns it) and equips it
+    void SpawnDefaultWeapon();
+
+    //Attaches the weapon to the right hand socket and makes it the active weapon
+    void EquipWeapon(AWeapon* WeaponToEquip);
+
+    //Detaches the equipped weapon and drops it in front of the character
+    void DropWeapon();
+
+    //Adds a traced item to the inventory, equipping it if it is a weapon
+    void PickupItem(AItem* Item);
+
+    //Switches to the next weapon stored in the inventory
+    void CycleWeapon();
+
+    void SelectButtonPressed();
+    void DropButtonPressed();
+    void NextWeaponButtonPressed();
+
+    //Starts replay recording or playback when requested on the command line
+    void InitReplay(APlayerController* PlayerController);
+
+    //Writes the recorded frame or feeds the next played back frame into the input handlers
+    void TickReplay(float DeltaTime);
+
+    //Reads the record for the next frame and makes its delta time the engine's next fixed step
+    bool ReadNextPlaybackFrame();
+
+    //Compares the shots fired during playback against the recorded shots read so far
+    void CompareReplayShots();
+
+    //Logs the playback results and hands control back (or exits with -ShooterReplayExit)
+    void FinishReplayPlayback();
+
+    //Records a resolved shot, or checks it against the replay during playback
+    void RecordReplayShot(const FVector& Start, const FVector& End, bool bHit);
+
 public:
     // Called every frame
     virtual void Tick(float DeltaTime) override;
@@ -178,6 +288,96 @@ private:
     //True if should trace every frame for items
     bool bShouldTraceForItems;
 
+    //Number of overlapped items
+    int32 OverlappedItemCount;
+
+    //Item currently under the crosshair, null if none
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Items, meta = (AllowPrivateAccess = "true"))
+    AItem* TraceHitItem;
+
+    //Item hit by the trace last frame
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Items, meta = (AllowPrivateAccess = "true"))
+    AItem* TraceHitItemLastFrame;
+
+    //Currently equipped weapon
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true"))
+    AWeapon* EquippedWeapon;
+
+    //Weapon class equipped when the game starts
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true"))
+    TSubclassOf<AWeapon> DefaultWeaponClass;
+
+    //Camera zoom and sensitivity, runs after movement
+    FShooterCharacterTickFunction CameraTickFunction;
+
+    //Crosshair spread, runs after movement on any thread
+    FShooterCharacterTickFunction SpreadTickFunction;
+
+    //Item trace under the crosshair, runs after physics while items are overlapped
+    FShooterCharacterTickFunction ItemTraceTickFunction;
+
+    //False runs every stage from the actor tick like before the split, set from Shooter.SplitCharacterTick when registering
+    bool bSplitTickStages;
+
+    //Base seed for the bullet spread, a given seed always scatters the same way (used by replay playback)
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Combat, meta = (AllowPrivateAccess = "true"))
+    int32 ShotRandomSeed;
+
+    //Shots fired so far, combined with ShotRandomSeed to seed each shot's spread
+    int32 ShotCounter;
+
+    //Shots fired since the fire button was pressed, indexes the recoil pattern
+    int32 RecoilShotIndex;
+
+    //Reused between shots to avoid allocating per shot
+    TArray<FVector> PelletDirections;
+
+    //Simulation used by projectile weapons
+    UPROPERTY(Transient)
+    class AProjectileSimulation* ProjectileSimulation;
+
+    //Hits of the last shot's pellets, reused between shots
+    TArray<FHitResult> PelletHits;
+
+    //Weapons carried by the character, including the equipped one
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Inventory, meta = (AllowPrivateAccess = "true"))
+    TArray<AWeapon*> Inventory;
+
+    //Maximum number of weapons the character can carry
+    UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = Inventory, meta = (AllowPrivateAccess = "true", ClampMin = "1"))
+    int32 InventoryCapacity;
+
+    //Replay recording, active with -ShooterRecord
+    TUniquePtr<FShooterReplayWriter> ReplayWriter;
+
+    //Replay playback, active with -ShooterReplay
+    TUniquePtr<FShooterReplayReader> ReplayReader;
+
+    //Inputs and shots gathered during the current frame
+    FShooterReplayFrame ReplayFrame;
+
+    //Frame decoded from the replay during playback, and the one after it
+    FShooterReplayFrame PlaybackFrame;
+    FShooterReplayFrame NextPlaybackFrame;
+    bool bHasNextPlaybackFrame;
+
+    //Shots from the replay that playback has not reproduced yet
+    TArray<FShooterReplayShot> ExpectedReplayShots;
+    int32 ExpectedReplayShotIndex;
+
+    //Shots fired during playback, compared once the record they were written to has been read
+    TArray<FShooterReplayShot> PlayedReplayShots;
+
+    //Engine time step settings to restore when playback ends
+    bool bUseFixedTimeStepBeforeReplay;
+    double FixedDeltaTimeBeforeReplay;
+
+    //Played back shots that did not match the recording
+    int32 ReplayShotMismatches;
+
+    //Recorded game time, or wall clock time when playback started
+    double ReplayTime;
+
 public:
     /* Returns camera boom sub-object */
     FORCEINLINE USpringArmComponent* GetCameraBoom() const { return CameraBoom; }
@@ -191,4 +391,14 @@ public:
     // Blueprint callable function to get crosshair spread multiplier
     UFUNCTION(BlueprintCallable)
     float GetCrosshairSpreadMultiplier() const;
+
+    FORCEINLINE int32 GetOverlappedItemCount() const { return OverlappedItemCount; }
+
+    //Adds/subtracts to/from OverlappedItemCount and updates bShouldTraceForItems
+    void IncrementOverlappedItemCount(int32 Amount);
+
+    FORCEINLINE AWeapon* GetEquippedWeapon() const { return EquippedWeapon; }
+
+    //Called by the projectile simulation when one of our projectiles hits something
+    void OnProjectileImpact(const FVector& Origin, const FHitResult& Hit);
 };
@@ -2,4 +2,10 @@
 
 
 #include "ShooterGameModeBase.h"
+#include "ShooterHUD.h"
+
+AShooterGameModeBase::AShooterGameModeBase()
+{
+	HUDClass = AShooterHUD::StaticClass();
+}
 
@@ -0,0 +1,75 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterHUD.h"
+#include "PickupPromptWidget.h"
+#include "Item.h"
+
+AShooterHUD::AShooterHUD() :
+	PickupPromptClass(UPickupPromptWidget::StaticClass()), PromptWorldOffset(0.0f, 0.0f, 50.0f), PickupPrompt(nullptr), FocusedItem(nullptr)
+{
+	// Tick to keep the prompt on top of the focused item
+	PrimaryActorTick.bCanEverTick = true;
+}
+
+void AShooterHUD::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (PickupPromptClass && PlayerOwner) {
+		PickupPrompt = CreateWidget<UPickupPromptWidget>(PlayerOwner, PickupPromptClass);
+		if (PickupPrompt) {
+			PickupPrompt->AddToViewport();
+			PickupPrompt->SetAlignmentInViewport(FVector2D(0.5f, 1.0f));
+			PickupPrompt->SetVisibility(ESlateVisibility::Collapsed);
+		}
+	}
+}
+
+void AShooterHUD::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	if (FocusedItem) {
+		UpdatePromptPosition();
+	}
+}
+
+void AShooterHUD::SetFocusedItem(AItem* Item)
+{
+	if (Item == FocusedItem) {
+		return;
+	}
+	FocusedItem = Item;
+
+	if (PickupPrompt == nullptr) {
+		return;
+	}
+
+	if (FocusedItem) {
+		//Only refresh the widget contents when the focus changes
+		PickupPrompt->SetPickupInfo(FocusedItem->GetPickupInfo());
+		UpdatePromptPosition();
+	}
+	else {
+		PickupPrompt->SetVisibility(ESlateVisibility::Collapsed);
+	}
+}
+
+void AShooterHUD::UpdatePromptPosition()
+{
+	if (PickupPrompt == nullptr || PlayerOwner == nullptr) {
+		return;
+	}
+
+	FVector2D ScreenPosition;
+	const bool bOnScreen = PlayerOwner->ProjectWorldLocationToScreen(FocusedItem->GetActorLocation() + PromptWorldOffset, ScreenPosition, true);
+
+	if (bOnScreen) {
+		PickupPrompt->SetPositionInViewport(ScreenPosition);
+		PickupPrompt->SetVisibility(ESlateVisibility::HitTestInvisible);
+	}
+	else {
+		PickupPrompt->SetVisibility(ESlateVisibility::Collapsed);
+	}
+}
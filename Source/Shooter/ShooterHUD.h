@@ -0,0 +1,50 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/HUD.h"
+#include "ShooterHUD.generated.h"
+
+class AItem;
+class UPickupPromptWidget;
+
+/**
+ * Owns the single pickup prompt and projects it onto the item the local player is looking at
+ */
+UCLASS()
+class SHOOTER_API AShooterHUD : public AHUD
+{
+	GENERATED_BODY()
+
+public:
+	AShooterHUD();
+
+	// Called every frame
+	virtual void Tick(float DeltaTime) override;
+
+	//Item to show the pickup prompt for, null hides the prompt
+	void SetFocusedItem(AItem* Item);
+
+protected:
+	// Called when the game starts or when spawned
+	virtual void BeginPlay() override;
+
+private:
+	//Moves the prompt to the focused item's screen position
+	void UpdatePromptPosition();
+
+	//Widget class for the shared pickup prompt, defaults to the plain text prompt
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Pickup", meta = (AllowPrivateAccess = "true"))
+	TSubclassOf<UPickupPromptWidget> PickupPromptClass;
+
+	//World space offset from the item's location to where the prompt is anchored
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Pickup", meta = (AllowPrivateAccess = "true"))
+	FVector PromptWorldOffset;
+
+	UPROPERTY(Transient)
+	UPickupPromptWidget* PickupPrompt;
+
+	UPROPERTY(Transient)
+	AItem* FocusedItem;
+};
@@ -0,0 +1,366 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ShooterReplay.h"
+#include "HAL/PlatformFileManager.h"
+#include "Async/MappedFileHandle.h"
+#include "Misc/Paths.h"
+
+namespace
+{
+	// 'SRPL'
+	constexpr uint32 ReplayMagic = 0x4C505253;
+	constexpr uint16 ReplayVersion = 2;
+	constexpr int32 HeaderSize = sizeof(uint32) + sizeof(uint16) + sizeof(uint16);
+
+	// Bytes buffered before they are appended to the file
+	constexpr int32 FlushThreshold = 16 * 1024;
+
+	// Frame record flags
+	constexpr uint8 FrameHasAxes = 1 << 0;
+	constexpr uint8 FrameHasButtons = 1 << 1;
+	constexpr uint8 FrameHasShots = 1 << 2;
+
+	uint32 ZigZagEncode(int32 Value)
+	{
+		return (static_cast<uint32>(Value) << 1) ^ static_cast<uint32>(Value >> 31);
+	}
+
+	int32 ZigZagDecode(uint32 Value)
+	{
+		return static_cast<int32>(Value >> 1) ^ -static_cast<int32>(Value & 1);
+	}
+
+	int32 Quantize(float Value, float Scale)
+	{
+		return FMath::RoundToInt(Value * Scale);
+	}
+
+	void QuantizeShot(const FShooterReplayShot& Shot, int32 (&OutValues)[6])
+	{
+		OutValues[0] = Quantize(Shot.Start.X, ShooterReplay::LocationScale);
+		OutValues[1] = Quantize(Shot.Start.Y, ShooterReplay::LocationScale);
+		OutValues[2] = Quantize(Shot.Start.Z, ShooterReplay::LocationScale);
+		OutValues[3] = Quantize(Shot.End.X, ShooterReplay::LocationScale);
+		OutValues[4] = Quantize(Shot.End.Y, ShooterReplay::LocationScale);
+		OutValues[5] = Quantize(Shot.End.Z, ShooterReplay::LocationScale);
+	}
+}
+
+void FShooterReplayFrame::Reset()
+{
+	DeltaTime = 0.0f;
+	MoveForward = MoveRight = TurnRate = LookUpRate = 0.0f;
+	Buttons = EShooterReplayButton::None;
+	Shots.Reset();
+}
+
+FString ShooterReplay::ResolveReplayPath(const FString& FileName)
+{
+	if (FPaths::IsRelative(FileName)) {
+		return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Replays"), FileName);
+	}
+	return FileName;
+}
+
+FShooterReplayWriter::~FShooterReplayWriter()
+{
+	Close();
+}
+
+bool FShooterReplayWriter::Open(const FString& FileName, uint16 FixedStepHz)
+{
+	Close();
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	PlatformFile.CreateDirectoryTree(*FPaths::GetPath(FileName));
+
+	FileHandle.Reset(PlatformFile.OpenWrite(*FileName));
+	if (!FileHandle) {
+		UE_LOG(LogTemp, Warning, TEXT("Could not open replay file %s for writing"), *FileName);
+		return false;
+	}
+
+	FMemory::Memzero(PreviousAxes);
+	FMemory::Memzero(PreviousShot);
+	BytesWritten = 0;
+	FramesWritten = 0;
+	Buffer.Reset(FlushThreshold + 256);
+
+	//Header
+	for (int32 Shift = 0; Shift < 32; Shift += 8) {
+		WriteByte(static_cast<uint8>(ReplayMagic >> Shift));
+	}
+	WriteByte(static_cast<uint8>(ReplayVersion));
+	WriteByte(static_cast<uint8>(ReplayVersion >> 8));
+	WriteByte(static_cast<uint8>(FixedStepHz));
+	WriteByte(static_cast<uint8>(FixedStepHz >> 8));
+
+	return true;
+}
+
+void FShooterReplayWriter::WriteFrame(const FShooterReplayFrame& Frame)
+{
+	if (!FileHandle) {
+		return;
+	}
+
+	const int32 Axes[4] = {
+		Quantize(Frame.MoveForward, ShooterReplay::AxisScale),
+		Quantize(Frame.MoveRight, ShooterReplay::AxisScale),
+		Quantize(Frame.TurnRate, ShooterReplay::AxisScale),
+		Quantize(Frame.LookUpRate, ShooterReplay::AxisScale)
+	};
+
+	uint8 AxisMask = 0;
+	for (int32 Index = 0; Index < 4; ++Index) {
+		if (Axes[Index] != PreviousAxes[Index]) {
+			AxisMask |= 1 << Index;
+		}
+	}
+
+	uint8 Flags = 0;
+	Flags |= AxisMask != 0 ? FrameHasAxes : 0;
+	Flags |= Frame.Buttons != EShooterReplayButton::None ? FrameHasButtons : 0;
+	Flags |= Frame.Shots.Num() > 0 ? FrameHasShots : 0;
+
+	WriteByte(Flags);
+	WriteVarUInt(static_cast<uint32>(FMath::Max(0, FMath::RoundToInt(Frame.DeltaTime * 1'000'000.0f))));
+
+	if (Flags & FrameHasAxes) {
+		WriteByte(AxisMask);
+		for (int32 Index = 0; Index < 4; ++Index) {
+			if (AxisMask & (1 << Index)) {
+				WriteVarDelta(Axes[Index], PreviousAxes[Index]);
+			}
+		}
+	}
+
+	if (Flags & FrameHasButtons) {
+		WriteVarUInt(static_cast<uint32>(Frame.Buttons));
+	}
+
+	if (Flags & FrameHasShots) {
+		WriteVarUInt(static_cast<uint32>(Frame.Shots.Num()));
+		for (const FShooterReplayShot& Shot : Frame.Shots) {
+			int32 Values[6];
+			QuantizeShot(Shot, Values);
+
+			WriteByte(Shot.bHit ? 1 : 0);
+			for (int32 Index = 0; Index < 6; ++Index) {
+				WriteVarDelta(Values[Index], PreviousShot[Index]);
+			}
+		}
+	}
+
+	++FramesWritten;
+
+	if (Buffer.Num() >= FlushThreshold) {
+		Flush();
+	}
+}
+
+void FShooterReplayWriter::Close()
+{
+	if (FileHandle) {
+		Flush();
+		FileHandle->Flush();
+		FileHandle.Reset();
+	}
+}
+
+void FShooterReplayWriter::Flush()
+{
+	if (FileHandle && Buffer.Num() > 0) {
+		FileHandle->Write(Buffer.GetData(), Buffer.Num());
+		BytesWritten += Buffer.Num();
+		Buffer.Reset();
+	}
+}
+
+void FShooterReplayWriter::WriteByte(uint8 Value)
+{
+	Buffer.Add(Value);
+}
+
+void FShooterReplayWriter::WriteVarUInt(uint32 Value)
+{
+	while (Value >= 0x80) {
+		Buffer.Add(static_cast<uint8>(Value | 0x80));
+		Value >>= 7;
+	}
+	Buffer.Add(static_cast<uint8>(Value));
+}
+
+void FShooterReplayWriter::WriteVarDelta(int32 Value, int32& Previous)
+{
+	WriteVarUInt(ZigZagEncode(Value - Previous));
+	Previous = Value;
+}
+
+FShooterReplayReader::~FShooterReplayReader()
+{
+	Close();
+}
+
+bool FShooterReplayReader::Open(const FString& FileName)
+{
+	Close();
+
+	FMemory::Memzero(PreviousAxes);
+	FMemory::Memzero(PreviousShot);
+	FramesRead = 0;
+	bCorrupt = false;
+
+	MappedFile.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*FileName));
+	if (!MappedFile) {
+		UE_LOG(LogTemp, Warning, TEXT("Could not map replay file %s"), *FileName);
+		return false;
+	}
+
+	MappedRegion.Reset(MappedFile->MapRegion(0, MappedFile->GetFileSize(), true));
+	if (!MappedRegion) {
+		UE_LOG(LogTemp, Warning, TEXT("Could not map replay file %s"), *FileName);
+		MappedFile.Reset();
+		return false;
+	}
+
+	Begin = MappedRegion->GetMappedPtr();
+	End = Begin + MappedRegion->GetMappedSize();
+	Cursor = Begin;
+
+	//Header
+	uint32 Magic = 0;
+	uint16 Version = 0;
+	if (End - Begin < HeaderSize) {
+		bCorrupt = true;
+	}
+	else {
+		Magic = Cursor[0] | (Cursor[1] << 8) | (Cursor[2] << 16) | (static_cast<uint32>(Cursor[3]) << 24);
+		Version = static_cast<uint16>(Cursor[4] | (Cursor[5] << 8));
+		FixedStepHz = static_cast<uint16>(Cursor[6] | (Cursor[7] << 8));
+		Cursor += HeaderSize;
+	}
+
+	if (bCorrupt || Magic != ReplayMagic || Version != ReplayVersion || FixedStepHz == 0) {
+		UE_LOG(LogTemp, Warning, TEXT("%s is not a supported replay file"), *FileName);
+		Close();
+		return false;
+	}
+	return true;
+}
+
+bool FShooterReplayReader::ReadFrame(FShooterReplayFrame& OutFrame)
+{
+	OutFrame.Reset();
+
+	if (Cursor == nullptr || Cursor >= End) {
+		return false;
+	}
+
+	uint8 Flags = 0;
+	uint32 DeltaMicros = 0;
+	if (!ReadByte(Flags) || !ReadVarUInt(DeltaMicros)) {
+		bCorrupt = true;
+		return false;
+	}
+	OutFrame.DeltaTime = DeltaMicros / 1'000'000.0f;
+
+	if (Flags & FrameHasAxes) {
+		uint8 AxisMask = 0;
+		if (!ReadByte(AxisMask)) {
+			bCorrupt = true;
+			return false;
+		}
+		for (int32 Index = 0; Index < 4; ++Index) {
+			if ((AxisMask & (1 << Index)) && !ReadVarDelta(PreviousAxes[Index])) {
+				bCorrupt = true;
+				return false;
+			}
+		}
+	}
+	OutFrame.MoveForward = PreviousAxes[0] / ShooterReplay::AxisScale;
+	OutFrame.MoveRight = PreviousAxes[1] / ShooterReplay::AxisScale;
+	OutFrame.TurnRate = PreviousAxes[2] / ShooterReplay::AxisScale;
+	OutFrame.LookUpRate = PreviousAxes[3] / ShooterReplay::AxisScale;
+
+	if (Flags & FrameHasButtons) {
+		uint32 Buttons = 0;
+		if (!ReadVarUInt(Buttons) || Buttons > MAX_uint16) {
+			bCorrupt = true;
+			return false;
+		}
+		OutFrame.Buttons = static_cast<EShooterReplayButton>(Buttons);
+	}
+
+	if (Flags & FrameHasShots) {
+		uint32 NumShots = 0;
+		if (!ReadVarUInt(NumShots) || NumShots > static_cast<uint32>(End - Cursor)) {
+			bCorrupt = true;
+			return false;
+		}
+
+		OutFrame.Shots.SetNum(NumShots);
+		for (FShooterReplayShot& Shot : OutFrame.Shots) {
+			uint8 bHit = 0;
+			if (!ReadByte(bHit)) {
+				bCorrupt = true;
+				return false;
+			}
+			for (int32 Index = 0; Index < 6; ++Index) {
+				if (!ReadVarDelta(PreviousShot[Index])) {
+					bCorrupt = true;
+					return false;
+				}
+			}
+			Shot.bHit = bHit != 0;
+			Shot.Start = FVector(PreviousShot[0], PreviousShot[1], PreviousShot[2]) / ShooterReplay::LocationScale;
+			Shot.End = FVector(PreviousShot[3], PreviousShot[4], PreviousShot[5]) / ShooterReplay::LocationScale;
+		}
+	}
+
+	++FramesRead;
+	return true;
+}
+
+void FShooterReplayReader::Close()
+{
+	MappedRegion.Reset();
+	MappedFile.Reset();
+	Begin = Cursor = End = nullptr;
+}
+
+bool FShooterReplayReader::ReadByte(uint8& OutValue)
+{
+	if (Cursor >= End) {
+		return false;
+	}
+	OutValue = *Cursor++;
+	return true;
+}
+
+bool FShooterReplayReader::ReadVarUInt(uint32& OutValue)
+{
+	OutValue = 0;
+	for (int32 Shift = 0; Shift < 35; Shift += 7) {
+		uint8 Byte = 0;
+		if (!ReadByte(Byte)) {
+			return false;
+		}
+		OutValue |= static_cast<uint32>(Byte & 0x7F) << Shift;
+		if ((Byte & 0x80) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool FShooterReplayReader::ReadVarDelta(int32& InOutPrevious)
+{
+	uint32 Encoded = 0;
+	if (!ReadVarUInt(Encoded)) {
+		return false;
+	}
+	InOutPrevious += ZigZagDecode(Encoded);
+	return true;
+}
@@ -0,0 +1,149 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class IFileHandle;
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/**
+ * Compact binary recording of a shooter session, used to reproduce hitches and hit-registration issues.
+ *
+ * Record with:   -ShooterRecord=<File>
+ * Play back with: -ShooterReplay=<File> [-ShooterReplayExit] -nullrhi -unattended
+ *
+ * File layout: a fixed header followed by one variable length record per frame. Each record holds the
+ * frame's delta time, and playback steps the engine by that same delta time. Axis values and shot
+ * locations are quantized to integers and stored as zigzag varint deltas against the previous value,
+ * so idle frames cost a couple of bytes.
+ */
+
+// Button edges captured during a frame
+enum class EShooterReplayButton : uint16
+{
+	None = 0,
+	FirePressed = 1 << 0,
+	FireReleased = 1 << 1,
+	AimPressed = 1 << 2,
+	AimReleased = 1 << 3,
+	JumpPressed = 1 << 4,
+	JumpReleased = 1 << 5,
+	Select = 1 << 6,
+	Drop = 1 << 7,
+	NextWeapon = 1 << 8
+};
+ENUM_CLASS_FLAGS(EShooterReplayButton)
+
+// A resolved shot from the barrel to the beam end
+struct FShooterReplayShot
+{
+	FVector Start = FVector::ZeroVector;
+	FVector End = FVector::ZeroVector;
+	bool bHit = false;
+};
+
+// Everything the character received or produced in one frame
+struct FShooterReplayFrame
+{
+	float DeltaTime = 0.0f;
+
+	float MoveForward = 0.0f;
+	float MoveRight = 0.0f;
+	float TurnRate = 0.0f;
+	float LookUpRate = 0.0f;
+
+	EShooterReplayButton Buttons = EShooterReplayButton::None;
+
+	TArray<FShooterReplayShot> Shots;
+
+	void Reset();
+};
+
+namespace ShooterReplay
+{
+	// Axis values are stored in 1/1024 steps
+	constexpr float AxisScale = 1024.0f;
+
+	// Shot locations are stored in 1/10 cm steps
+	constexpr float LocationScale = 10.0f;
+
+	// Frame rate used for fixed step playback
+	constexpr uint16 DefaultFixedStepHz = 60;
+
+	// Resolves a command line file name against Saved/Replays
+	FString ResolveReplayPath(const FString& FileName);
+}
+
+/**
+ * Appends frames to a replay file, flushing the encoded bytes in chunks
+ */
+class SHOOTER_API FShooterReplayWriter
+{
+public:
+	~FShooterReplayWriter();
+
+	bool Open(const FString& FileName, uint16 FixedStepHz = ShooterReplay::DefaultFixedStepHz);
+	void WriteFrame(const FShooterReplayFrame& Frame);
+	void Close();
+
+	bool IsOpen() const { return FileHandle.IsValid(); }
+	int64 GetBytesWritten() const { return BytesWritten; }
+	int32 GetFramesWritten() const { return FramesWritten; }
+
+private:
+	void Flush();
+	void WriteByte(uint8 Value);
+	void WriteVarUInt(uint32 Value);
+	void WriteVarDelta(int32 Value, int32& Previous);
+
+	TUniquePtr<IFileHandle> FileHandle;
+	TArray<uint8> Buffer;
+
+	int32 PreviousAxes[4] = {};
+	int32 PreviousShot[6] = {};
+
+	int64 BytesWritten = 0;
+	int32 FramesWritten = 0;
+};
+
+/**
+ * Reads frames back from a memory-mapped replay file
+ */
+class SHOOTER_API FShooterReplayReader
+{
+public:
+	~FShooterReplayReader();
+
+	bool Open(const FString& FileName);
+	bool ReadFrame(FShooterReplayFrame& OutFrame);
+	void Close();
+
+	uint16 GetFixedStepHz() const { return FixedStepHz; }
+	int64 GetFileSize() const { return End - Begin; }
+	int32 GetFramesRead() const { return FramesRead; }
+
+	// True if decoding stopped on a truncated or malformed record
+	bool IsCorrupt() const { return bCorrupt; }
+
+private:
+	bool ReadByte(uint8& OutValue);
+	bool ReadVarUInt(uint32& OutValue);
+	bool ReadVarDelta(int32& InOutPrevious);
+
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+
+	const uint8* Begin = nullptr;
+	const uint8* Cursor = nullptr;
+	const uint8* End = nullptr;
+
+	uint16 FixedStepHz = ShooterReplay::DefaultFixedStepHz;
+
+	int32 PreviousAxes[4] = {};
+	int32 PreviousShot[6] = {};
+
+	int32 FramesRead = 0;
+	bool bCorrupt = false;
+};
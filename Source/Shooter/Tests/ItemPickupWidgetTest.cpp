@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "ShooterTestWorld.h"
+#include "Item.h"
+#include "PickupPromptWidget.h"
+#include "HAL/PlatformMemory.h"
+#include "UObject/UObjectArray.h"
+#include "UObject/UObjectGlobals.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FItemPickupWidgetMemoryTest, "Shooter.Items.PickupWidgetMemory1k",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter)
+
+bool FItemPickupWidgetMemoryTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 NumItems = 1'000;
+
+	FShooterTestWorld TestWorld;
+	UWorld* World = TestWorld.World;
+
+	struct FItemCost
+	{
+		int32 Objects = 0;
+		int64 Memory = 0;
+	};
+
+	// Spawns the items, measures what they added and destroys them again
+	auto MeasureItems = [World](bool bUsePickupWidgetComponent) -> FItemCost {
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+		const int32 ObjectsBefore = GUObjectArray.GetObjectArrayNumMinusAvailable();
+		const int64 MemoryBefore = FPlatformMemory::GetStats().UsedPhysical;
+
+		TArray<AItem*> Items;
+		Items.Reserve(NumItems);
+		for (int32 Index = 0; Index < NumItems; ++Index) {
+			const FTransform Transform(FVector(Index * 100.0f, 0.0f, 0.0f));
+			AItem* Item = World->SpawnActorDeferred<AItem>(AItem::StaticClass(), Transform);
+			Item->bUsePickupWidgetComponent = bUsePickupWidgetComponent;
+			Item->PickupWidgetClass = UPickupPromptWidget::StaticClass();
+			Item->FinishSpawning(Transform);
+			Items.Add(Item);
+		}
+
+		FItemCost Cost;
+		Cost.Objects = GUObjectArray.GetObjectArrayNumMinusAvailable() - ObjectsBefore;
+		Cost.Memory = static_cast<int64>(FPlatformMemory::GetStats().UsedPhysical) - MemoryBefore;
+
+		for (AItem* Item : Items) {
+			Item->Destroy();
+		}
+		return Cost;
+	};
+
+	const FItemCost SharedPrompt = MeasureItems(false);
+	const FItemCost WidgetComponents = MeasureItems(true);
+
+	AddInfo(FString::Printf(TEXT("%d items with the shared HUD prompt: %d UObjects, %lld bytes (%.1f UObjects, %lld bytes per item)"),
+		NumItems, SharedPrompt.Objects, SharedPrompt.Memory, static_cast<float>(SharedPrompt.Objects) / NumItems, SharedPrompt.Memory / NumItems));
+	AddInfo(FString::Printf(TEXT("%d items with a widget component each: %d UObjects, %lld bytes (%.1f UObjects, %lld bytes per item)"),
+		NumItems, WidgetComponents.Objects, WidgetComponents.Memory, static_cast<float>(WidgetComponents.Objects) / NumItems, WidgetComponents.Memory / NumItems));
+
+	// Used memory is noisy, the UObject count is what the shared prompt is expected to save
+	TestTrue(TEXT("Shared prompt creates fewer UObjects per item"), SharedPrompt.Objects < WidgetComponents.Objects);
+
+	return true;
+}
+
+#endif
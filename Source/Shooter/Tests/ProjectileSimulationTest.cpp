@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "ShooterTestWorld.h"
+#include "ProjectileSimulation.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FProjectileSimulationBenchmarkTest, "Shooter.Projectiles.Step5kBenchmark",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter)
+
+bool FProjectileSimulationBenchmarkTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 NumProjectiles = 5'000;
+	constexpr int32 WarmupSteps = 10;
+	constexpr int32 MeasuredSteps = 120;
+
+	FShooterTestWorld TestWorld;
+	UWorld* World = TestWorld.World;
+
+	AProjectileSimulation* Simulation = World->SpawnActor<AProjectileSimulation>();
+	if (!TestNotNull(TEXT("Simulation spawned"), Simulation)) {
+		return false;
+	}
+
+	// Fan the projectiles out upwards so the empty world never stops them and every step sweeps all 5k
+	FRandomStream Stream(NumProjectiles);
+	for (int32 Index = 0; Index < NumProjectiles; ++Index) {
+		const FVector Direction = Stream.VRandCone(FVector::UpVector, FMath::DegreesToRadians(45.0f));
+		Simulation->LaunchProjectile(FVector::ZeroVector, Direction * 30'000.0f, 1.0f, 0.00001f, 60.0f, nullptr);
+	}
+	TestEqual(TEXT("Every projectile launched"), Simulation->GetNumProjectiles(), NumProjectiles);
+
+	const float StepTime = 1.0f / Simulation->StepRate;
+	for (int32 Step = 0; Step < WarmupSteps; ++Step) {
+		Simulation->StepProjectiles(StepTime);
+	}
+
+	// Time the same scope STAT_ProjectileStep covers
+	double TotalMs = 0.0;
+	double MinMs = TNumericLimits<double>::Max();
+	double MaxMs = 0.0;
+	for (int32 Step = 0; Step < MeasuredSteps; ++Step) {
+		const double StartTime = FPlatformTime::Seconds();
+		Simulation->StepProjectiles(StepTime);
+		const double StepMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+		TotalMs += StepMs;
+		MinMs = FMath::Min(MinMs, StepMs);
+		MaxMs = FMath::Max(MaxMs, StepMs);
+	}
+
+	AddInfo(FString::Printf(TEXT("STAT_ProjectileStep with %d projectiles: %.3f ms avg, %.3f ms min, %.3f ms max per step over %d steps"),
+		Simulation->GetNumProjectiles(), TotalMs / MeasuredSteps, MinMs, MaxMs, MeasuredSteps));
+
+	TestEqual(TEXT("All projectiles still in flight"), Simulation->GetNumProjectiles(), NumProjectiles);
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,98 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "ShooterTestWorld.h"
+#include "ShooterCharacter.h"
+#include "HAL/IConsoleManager.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShooterCharacterTickBenchmarkTest, "Shooter.Characters.Tick64Benchmark",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::PerfFilter)
+
+bool FShooterCharacterTickBenchmarkTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 NumCharacters = 64;
+	constexpr int32 WarmupFrames = 10;
+	constexpr int32 MeasuredFrames = 120;
+	constexpr float FrameTime = 1.0f / 60.0f;
+
+	IConsoleVariable* SplitTickVar = IConsoleManager::Get().FindConsoleVariable(TEXT("Shooter.SplitCharacterTick"));
+	if (!TestNotNull(TEXT("Shooter.SplitCharacterTick exists"), SplitTickVar)) {
+		return false;
+	}
+	const int32 PreviousSplitTick = SplitTickVar->GetInt();
+
+	struct FTickTimes
+	{
+		double WorldTickMs = 0.0;
+		double CameraMs = 0.0;
+		double SpreadMs = 0.0;
+		double ItemTraceMs = 0.0;
+	};
+
+	// Ticks 64 AI controlled characters with the given tick layout and returns the average ms per frame
+	auto MeasureTicks = [&](bool bSplitTickStages) -> FTickTimes {
+		// Characters read the layout when their tick functions register, so set it before spawning
+		IConsoleManager::Get().FindConsoleVariable(TEXT("Shooter.SplitCharacterTick"))->Set(bSplitTickStages ? 1 : 0, ECVF_SetByCode);
+
+		FShooterTestWorld TestWorld;
+		UWorld* World = TestWorld.World;
+
+		TArray<AShooterCharacter*> Characters;
+		for (int32 Index = 0; Index < NumCharacters; ++Index) {
+			const FVector Location((Index % 8) * 200.0f, (Index / 8) * 200.0f, 0.0f);
+			AShooterCharacter* Character = World->SpawnActor<AShooterCharacter>(Location, FRotator::ZeroRotator);
+			if (Character) {
+				Character->SpawnDefaultController();
+				Characters.Add(Character);
+			}
+		}
+		TestEqual(TEXT("Every character spawned"), Characters.Num(), NumCharacters);
+
+		for (int32 Frame = 0; Frame < WarmupFrames; ++Frame) {
+			World->Tick(LEVELTICK_All, FrameTime);
+		}
+
+		FTickTimes Times;
+		for (int32 Frame = 0; Frame < MeasuredFrames; ++Frame) {
+			const double StartTime = FPlatformTime::Seconds();
+			World->Tick(LEVELTICK_All, FrameTime);
+			Times.WorldTickMs += (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+			// Time the scopes the STAT_Shooter*Tick counters cover, for the characters that run each stage in this layout
+			auto TimeStage = [&](FShooterCharacterTickFunction AShooterCharacter::* TickFunction, void (AShooterCharacter::*TickMethod)(float)) -> double {
+				const double StageStart = FPlatformTime::Seconds();
+				for (AShooterCharacter* Character : Characters) {
+					if (!bSplitTickStages || (Character->*TickFunction).IsTickFunctionEnabled()) {
+						(Character->*TickMethod)(FrameTime);
+					}
+				}
+				return (FPlatformTime::Seconds() - StageStart) * 1000.0;
+			};
+			Times.CameraMs += TimeStage(&AShooterCharacter::CameraTickFunction, &AShooterCharacter::TickCamera);
+			Times.SpreadMs += TimeStage(&AShooterCharacter::SpreadTickFunction, &AShooterCharacter::TickCrosshairSpread);
+			Times.ItemTraceMs += TimeStage(&AShooterCharacter::ItemTraceTickFunction, &AShooterCharacter::TickItemTrace);
+		}
+
+		Times.WorldTickMs /= MeasuredFrames;
+		Times.CameraMs /= MeasuredFrames;
+		Times.SpreadMs /= MeasuredFrames;
+		Times.ItemTraceMs /= MeasuredFrames;
+		return Times;
+	};
+
+	const FTickTimes SingleTick = MeasureTicks(false);
+	const FTickTimes SplitTick = MeasureTicks(true);
+	SplitTickVar->Set(PreviousSplitTick, ECVF_SetByCode);
+
+	AddInfo(FString::Printf(TEXT("%d characters, single tick: world tick %.3f ms, camera %.3f ms, spread %.3f ms, item trace %.3f ms per frame"),
+		NumCharacters, SingleTick.WorldTickMs, SingleTick.CameraMs, SingleTick.SpreadMs, SingleTick.ItemTraceMs));
+	AddInfo(FString::Printf(TEXT("%d characters, split stages: world tick %.3f ms, camera %.3f ms, spread %.3f ms, item trace %.3f ms per frame"),
+		NumCharacters, SplitTick.WorldTickMs, SplitTick.CameraMs, SplitTick.SpreadMs, SplitTick.ItemTraceMs));
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,83 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "ShooterTestWorld.h"
+#include "ShooterCharacter.h"
+#include "Weapon.h"
+#include "WeaponPool.h"
+#include "HAL/PlatformMemory.h"
+#include "UObject/UObjectArray.h"
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWeaponPoolStressTest, "Shooter.Weapons.PoolPickupDropStress",
+	EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::StressFilter)
+
+bool FWeaponPoolStressTest::RunTest(const FString& Parameters)
+{
+	constexpr int32 WarmupCycles = 1'000;
+	constexpr int32 Cycles = 10'000;
+
+	// Memory may move a little from unrelated engine threads, but not by a cycle's worth of actors
+	constexpr uint64 MemoryTolerance = 4 * 1024 * 1024;
+
+	FShooterTestWorld TestWorld;
+	UWorld* World = TestWorld.World;
+
+	AWeaponPool* Pool = World->SpawnActorDeferred<AWeaponPool>(AWeaponPool::StaticClass(), FTransform::Identity);
+	Pool->WeaponClass = AWeapon::StaticClass();
+	Pool->PoolSize = 4;
+	Pool->bAllowGrowth = false;
+	Pool->FinishSpawning(FTransform::Identity);
+
+	AShooterCharacter* Character = World->SpawnActor<AShooterCharacter>(FVector::ZeroVector, FRotator::ZeroRotator);
+	if (!TestNotNull(TEXT("Character spawned"), Character)) {
+		return false;
+	}
+
+	auto RunCycle = [this, Pool, Character]() -> bool {
+		AWeapon* Weapon = Pool->AcquireWeapon(FTransform::Identity);
+		if (Weapon == nullptr) {
+			AddError(TEXT("Pool ran out of weapons"));
+			return false;
+		}
+		Character->PickupItem(Weapon);
+		Character->DropWeapon();
+		Weapon->ReturnToPool();
+		return true;
+	};
+
+	for (int32 Cycle = 0; Cycle < WarmupCycles; ++Cycle) {
+		if (!RunCycle()) {
+			return false;
+		}
+	}
+
+	const int32 ObjectsBefore = GUObjectArray.GetObjectArrayNumMinusAvailable();
+	const uint64 MemoryBefore = FPlatformMemory::GetStats().UsedPhysical;
+	const double StartTime = FPlatformTime::Seconds();
+
+	for (int32 Cycle = 0; Cycle < Cycles; ++Cycle) {
+		if (!RunCycle()) {
+			return false;
+		}
+	}
+
+	const double ElapsedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	const int32 ObjectsAfter = GUObjectArray.GetObjectArrayNumMinusAvailable();
+	const uint64 MemoryAfter = FPlatformMemory::GetStats().UsedPhysical;
+
+	AddInfo(FString::Printf(TEXT("%d pickup/drop cycles: %.2f ms total, %.4f ms per cycle, UObjects %d -> %d, used memory %llu -> %llu bytes"),
+		Cycles, ElapsedMs, ElapsedMs / Cycles, ObjectsBefore, ObjectsAfter, MemoryBefore, MemoryAfter));
+
+	// No new UObjects means nothing for the garbage collector to pick up later
+	TestEqual(TEXT("No UObjects created by pickup/drop cycles"), ObjectsAfter, ObjectsBefore);
+	TestEqual(TEXT("Pool did not grow"), Pool->PooledWeapons.Num(), 4);
+	TestEqual(TEXT("Every weapon returned to the pool"), Pool->FreeWeapons.Num(), 4);
+	TestTrue(TEXT("Memory stays flat"), MemoryAfter <= MemoryBefore + MemoryTolerance);
+
+	return true;
+}
+
+#endif
@@ -2,4 +2,82 @@
 
 
 #include "Weapon.h"
+#include "WeaponPool.h"
+#include "Curves/CurveFloat.h"
 
+AWeapon::AWeapon() :
+	DroppedLifeSpan(30.0f), OwningPool(nullptr), Ammo(30),
+	PelletCount(1), SpreadDegreesPerMultiplier(1.5f), RecoilPitchCurve(nullptr), RecoilYawCurve(nullptr), RecoilPatternLength(30),
+	FireMode(EWeaponFireMode::EFM_Hitscan), ProjectileSpeed(30'000.0f), ProjectileGravityScale(1.0f), ProjectileDrag(0.00001f), ProjectileLifeSpan(3.0f)
+{
+}
+
+void AWeapon::BeginPlay()
+{
+	Super::BeginPlay();
+
+	BuildRecoilPattern();
+}
+
+void AWeapon::BuildRecoilPattern()
+{
+	RecoilPattern.Reset();
+	if (RecoilPitchCurve == nullptr && RecoilYawCurve == nullptr) {
+		return;
+	}
+
+	RecoilPattern.Reserve(RecoilPatternLength);
+	for (int32 ShotIndex = 0; ShotIndex < RecoilPatternLength; ++ShotIndex) {
+		const float Pitch = RecoilPitchCurve ? RecoilPitchCurve->GetFloatValue(ShotIndex) : 0.0f;
+		const float Yaw = RecoilYawCurve ? RecoilYawCurve->GetFloatValue(ShotIndex) : 0.0f;
+		RecoilPattern.Add(FVector2D(Pitch, Yaw));
+	}
+}
+
+FVector2D AWeapon::GetRecoilKick(int32 ShotIndex) const
+{
+	if (RecoilPattern.Num() == 0) {
+		return FVector2D::ZeroVector;
+	}
+	return RecoilPattern[FMath::Clamp(ShotIndex, 0, RecoilPattern.Num() - 1)];
+}
+
+void AWeapon::GetPelletDirections(const FVector& AimDirection, float SpreadMultiplier, int32 ShotSeed, TArray<FVector>& OutDirections) const
+{
+	const float HalfAngleRad = FMath::DegreesToRadians(FMath::Max(SpreadMultiplier, 0.0f) * SpreadDegreesPerMultiplier);
+
+	OutDirections.Reset(PelletCount);
+	for (int32 Pellet = 0; Pellet < PelletCount; ++Pellet) {
+		//Each pellet gets its own stream so the result does not depend on evaluation order
+		const FRandomStream Stream(HashCombine(static_cast<uint32>(ShotSeed), static_cast<uint32>(Pellet)));
+		OutDirections.Add(HalfAngleRad > 0.0f ? Stream.VRandCone(AimDirection, HalfAngleRad) : AimDirection);
+	}
+}
+
+FItemPickupInfo AWeapon::GetPickupInfo() const
+{
+	FItemPickupInfo Info = Super::GetPickupInfo();
+	Info.ItemCount = Ammo;
+	return Info;
+}
+
+void AWeapon::ReturnToPool()
+{
+	ClearDroppedLifeSpan();
+
+	if (OwningPool) {
+		OwningPool->ReleaseWeapon(this);
+	}
+}
+
+void AWeapon::StartDroppedLifeSpan()
+{
+	if (OwningPool && DroppedLifeSpan > 0.0f) {
+		GetWorldTimerManager().SetTimer(DroppedLifeSpanTimer, this, &AWeapon::ReturnToPool, DroppedLifeSpan);
+	}
+}
+
+void AWeapon::ClearDroppedLifeSpan()
+{
+	GetWorldTimerManager().ClearTimer(DroppedLifeSpanTimer);
+}
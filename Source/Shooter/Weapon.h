@@ -6,6 +6,15 @@
 #include "Item.h"
 #include "Weapon.generated.h"
 
+UENUM(BlueprintType)
+enum class EWeaponFireMode : uint8
+{
+	EFM_Hitscan UMETA(DisplayName = "Hitscan"),
+	EFM_Projectile UMETA(DisplayName = "Projectile"),
+
+	EFM_MAX UMETA(DisplayName = "DefaultMAX")
+};
+
 /**
  *
  */
@@ -13,5 +22,99 @@ UCLASS()
 class SHOOTER_API AWeapon : public AItem
 {
 	GENERATED_BODY()
-	
+
+public:
+	AWeapon();
+
+	//Returns the weapon to the pool it came from, weapons without a pool stay where they are
+	void ReturnToPool();
+
+	//Starts the timer that recycles a dropped weapon nobody picked up, only for pooled weapons
+	void StartDroppedLifeSpan();
+
+	void ClearDroppedLifeSpan();
+
+	virtual FItemPickupInfo GetPickupInfo() const override;
+
+	//Fills one direction per pellet, scattered in a cone around AimDirection. Same seed gives the same directions.
+	void GetPelletDirections(const FVector& AimDirection, float SpreadMultiplier, int32 ShotSeed, TArray<FVector>& OutDirections) const;
+
+	//Pitch (X) and yaw (Y) kick in degrees for the given shot of a burst
+	FVector2D GetRecoilKick(int32 ShotIndex) const;
+
+protected:
+	// Called when the game starts or when spawned
+	virtual void BeginPlay() override;
+
+	//Samples the recoil curves into RecoilPattern
+	void BuildRecoilPattern();
+
+private:
+	//Seconds a dropped pooled weapon stays in the world before it is recycled, 0 keeps it forever
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true", ClampMin = "0.0"))
+	float DroppedLifeSpan;
+
+	//Pool this weapon is recycled through
+	UPROPERTY(VisibleInstanceOnly, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true"))
+	class AWeaponPool* OwningPool;
+
+	FTimerHandle DroppedLifeSpanTimer;
+
+	//Rounds loaded in the weapon
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon Properties", meta = (AllowPrivateAccess = "true", ClampMin = "0"))
+	int32 Ammo;
+
+	//Traces fired per shot, greater than one for shotguns
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon Properties|Spread", meta = (AllowPrivateAccess = "true", ClampMin = "1"))
+	int32 PelletCount;
+
+	//Cone half angle in degrees for each unit of crosshair spread
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon Properties|Spread", meta = (AllowPrivateAccess = "true", ClampMin = "0.0"))
+	float SpreadDegreesPerMultiplier;
+
+	//Pitch kick in degrees, indexed by shot number in the burst
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon Properties|Recoil", meta = (AllowPrivateAccess = "true"))
+	class UCurveFloat* RecoilPitchCurve;
+
+	//Yaw kick in degrees, indexed by shot number in the burst
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon Properties|Recoil", meta = (AllowPrivateAccess = "true"))
+	UCurveFloat* RecoilYawCurve;
+
+	//Number of shots sampled from the recoil curves, later shots reuse the last kick
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon Properties|Recoil", meta = (AllowPrivateAccess = "true", ClampMin = "1"))
+	int32 RecoilPatternLength;
+
+	//Recoil curves sampled per shot so firing never evaluates a curve
+	TArray<FVector2D> RecoilPattern;
+
+	//Instant traces, or simulated projectiles for snipers and launchers
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon Properties|Projectile", meta = (AllowPrivateAccess = "true"))
+	EWeaponFireMode FireMode;
+
+	//Muzzle velocity in cm/s
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon Properties|Projectile", meta = (AllowPrivateAccess = "true", ClampMin = "1.0", EditCondition = "FireMode == EWeaponFireMode::EFM_Projectile"))
+	float ProjectileSpeed;
+
+	//Multiplier on world gravity
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon Properties|Projectile", meta = (AllowPrivateAccess = "true", EditCondition = "FireMode == EWeaponFireMode::EFM_Projectile"))
+	float ProjectileGravityScale;
+
+	//Quadratic drag coefficient, deceleration is Drag * Speed^2
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon Properties|Projectile", meta = (AllowPrivateAccess = "true", ClampMin = "0.0", EditCondition = "FireMode == EWeaponFireMode::EFM_Projectile"))
+	float ProjectileDrag;
+
+	//Seconds before a projectile that hit nothing is removed
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Weapon Properties|Projectile", meta = (AllowPrivateAccess = "true", ClampMin = "0.1", EditCondition = "FireMode == EWeaponFireMode::EFM_Projectile"))
+	float ProjectileLifeSpan;
+
+public:
+	FORCEINLINE AWeaponPool* GetOwningPool() const { return OwningPool; }
+	FORCEINLINE void SetOwningPool(AWeaponPool* Pool) { OwningPool = Pool; }
+	FORCEINLINE int32 GetAmmo() const { return Ammo; }
+	FORCEINLINE int32 GetPelletCount() const { return PelletCount; }
+	FORCEINLINE EWeaponFireMode GetFireMode() const { return FireMode; }
+	FORCEINLINE float GetProjectileSpeed() const { return ProjectileSpeed; }
+	FORCEINLINE float GetProjectileGravityScale() const { return ProjectileGravityScale; }
+	FORCEINLINE float GetProjectileDrag() const { return ProjectileDrag; }
+	FORCEINLINE float GetProjectileLifeSpan() const { return ProjectileLifeSpan; }
 };
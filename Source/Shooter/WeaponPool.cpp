@@ -0,0 +1,93 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "WeaponPool.h"
+#include "Weapon.h"
+#include "EngineUtils.h"
+
+// Sets default values
+AWeaponPool::AWeaponPool() :
+	PoolSize(8), bAllowGrowth(true)
+{
+	// The pool only reacts to requests and never needs to tick
+	PrimaryActorTick.bCanEverTick = false;
+
+	SetRootComponent(CreateDefaultSubobject<USceneComponent>(TEXT("Root")));
+}
+
+// Called when the game starts or when spawned
+void AWeaponPool::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (!WeaponClass) {
+		return;
+	}
+
+	//Spawn the whole pool up front so gameplay never has to
+	PooledWeapons.Reserve(PoolSize);
+	FreeWeapons.Reserve(PoolSize);
+	for (int32 Index = 0; Index < PoolSize; ++Index) {
+		if (AWeapon* Weapon = SpawnPooledWeapon()) {
+			FreeWeapons.Add(Weapon);
+		}
+	}
+}
+
+AWeapon* AWeaponPool::SpawnPooledWeapon()
+{
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	AWeapon* Weapon = GetWorld()->SpawnActor<AWeapon>(WeaponClass, GetActorTransform(), SpawnParams);
+	if (Weapon) {
+		Weapon->SetOwningPool(this);
+		Weapon->SetItemState(EItemState::EIS_Pooled);
+		PooledWeapons.Add(Weapon);
+	}
+	return Weapon;
+}
+
+AWeapon* AWeaponPool::AcquireWeapon(const FTransform& SpawnTransform)
+{
+	AWeapon* Weapon = nullptr;
+
+	if (FreeWeapons.Num() > 0) {
+		Weapon = FreeWeapons.Pop(false);
+	}
+	else if (bAllowGrowth && WeaponClass) {
+		UE_LOG(LogTemp, Warning, TEXT("%s ran out of weapons, consider raising PoolSize"), *GetName());
+		Weapon = SpawnPooledWeapon();
+	}
+
+	if (Weapon) {
+		Weapon->SetActorTransform(SpawnTransform, false, nullptr, ETeleportType::TeleportPhysics);
+		Weapon->SetItemState(EItemState::EIS_Pickup);
+	}
+	return Weapon;
+}
+
+void AWeaponPool::ReleaseWeapon(AWeapon* Weapon)
+{
+	//Only weapons spawned by this pool can be returned to it
+	if (Weapon == nullptr || Weapon->GetOwningPool() != this || Weapon->GetItemState() == EItemState::EIS_Pooled) {
+		return;
+	}
+
+	Weapon->DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+	Weapon->SetItemState(EItemState::EIS_Pooled);
+	Weapon->SetActorTransform(GetActorTransform(), false, nullptr, ETeleportType::TeleportPhysics);
+	FreeWeapons.Add(Weapon);
+}
+
+AWeaponPool* AWeaponPool::FindPool(UWorld* World, TSubclassOf<AWeapon> Class)
+{
+	if (World && Class) {
+		for (TActorIterator<AWeaponPool> It(World); It; ++It) {
+			if (It->WeaponClass == Class) {
+				return *It;
+			}
+		}
+	}
+	return nullptr;
+}
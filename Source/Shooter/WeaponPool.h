@@ -0,0 +1,61 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "WeaponPool.generated.h"
+
+class AWeapon;
+
+/**
+ * Recycles weapon actors of a single class instead of spawning and destroying them.
+ * Place one per weapon class in a map and size it for that map.
+ */
+UCLASS()
+class SHOOTER_API AWeaponPool : public AActor
+{
+	GENERATED_BODY()
+
+	friend class FWeaponPoolStressTest;
+
+public:
+	// Sets default values for this actor's properties
+	AWeaponPool();
+
+	//Takes a weapon out of the pool and places it in the world as a pickup
+	AWeapon* AcquireWeapon(const FTransform& SpawnTransform);
+
+	//Deactivates the weapon and puts it back in the pool
+	void ReleaseWeapon(AWeapon* Weapon);
+
+	//Finds the pool in the world that recycles the given weapon class
+	static AWeaponPool* FindPool(UWorld* World, TSubclassOf<AWeapon> Class);
+
+protected:
+	// Called when the game starts or when spawned
+	virtual void BeginPlay() override;
+
+private:
+	AWeapon* SpawnPooledWeapon();
+
+	//Weapon class recycled by this pool
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Pool", meta = (AllowPrivateAccess = "true"))
+	TSubclassOf<AWeapon> WeaponClass;
+
+	//Number of weapons spawned up front when the map starts
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Pool", meta = (AllowPrivateAccess = "true", ClampMin = "0"))
+	int32 PoolSize;
+
+	//Spawn a new weapon when the pool runs dry instead of failing the request
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Pool", meta = (AllowPrivateAccess = "true"))
+	bool bAllowGrowth;
+
+	//Every weapon owned by the pool, keeps them referenced while in use
+	UPROPERTY(Transient)
+	TArray<AWeapon*> PooledWeapons;
+
+	//Weapons that are inactive and ready to be acquired
+	UPROPERTY(VisibleInstanceOnly, Transient, Category = "Pool")
+	TArray<AWeapon*> FreeWeapons;
+};